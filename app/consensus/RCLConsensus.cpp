@@ -25,6 +25,7 @@
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/ledger/LocalTxs.h>
 #include <ripple/app/ledger/OpenLedger.h>
+#include <ripple/app/main/CollectorManager.h>
 #include <ripple/app/misc/AmendmentTable.h>
 #include <ripple/app/misc/HashRouter.h>
 #include <ripple/app/misc/LoadFeeTrack.h>
@@ -33,6 +34,7 @@
 #include <ripple/app/misc/ValidatorKeys.h>
 #include <ripple/app/misc/ValidatorList.h>
 #include <ripple/app/tx/apply.h>
+#include <ripple/app/tx/ParallelApply.h>
 #include <ripple/basics/make_lock.h>
 #include <ripple/beast/core/LexicalCast.h>
 #include <ripple/consensus/LedgerTiming.h>
@@ -80,10 +82,13 @@ RCLConsensus::Adaptor::Adaptor(
         , localTxs_(localTxs)
         , inboundTransactions_{inboundTransactions}
         , j_(journal)
+        , closePipeline_(
+              app, app.getCollectorManager().collector(), journal)
         , nodeID_{calcNodeID(app.nodeIdentity().first)}
         , valPublic_{validatorKeys.publicKey}
         , valSecret_{validatorKeys.secretKey}
 {
+    parms_.ledgerADAPTIVE_CLOSE = app.config().ADAPTIVE_CLOSE;
 }
 
 boost::optional<RCLCxLedger>
@@ -225,6 +230,23 @@ RCLConsensus::Adaptor::hasOpenTransactions() const
     return !app_.openLedger().empty();
 }
 
+ConsensusBacklog
+RCLConsensus::Adaptor::openBacklog() const
+{
+    ConsensusBacklog backlog;
+    if (!parms_.ledgerADAPTIVE_CLOSE)
+        return backlog;
+
+    auto const current = app_.openLedger().current();
+    backlog.pending = current->txCount();
+    if (auto const metrics = app_.getTxQ().getMetrics(*current))
+        backlog.pending += metrics->txCount;
+
+    backlog.capacity = static_cast<std::size_t>(
+        applyRate_.load() * parms_.ledgerMIN_CLOSE.count() / 1000);
+    return backlog;
+}
+
 std::size_t
 RCLConsensus::Adaptor::proposersValidated(LedgerHash const& h) const
 {
@@ -407,6 +429,9 @@ RCLConsensus::Adaptor::doAccept(
     ConsensusMode const& mode,
     Json::Value && consensusJson)
 {
+    using clock_type = LedgerClosePipeline::clock_type;
+    auto const acceptStart = clock_type::now();
+
     prevProposers_ = result.proposers;
     prevRoundTime_ = result.roundTime.read();
 
@@ -522,6 +547,7 @@ RCLConsensus::Adaptor::doAccept(
         }
 
         // Build new open ledger
+        auto const openStart = clock_type::now();
         auto lock = make_lock(app_.getMasterMutex(), std::defer_lock);
         auto sl = make_lock(ledgerMaster_.peekMutex(), std::defer_lock);
         std::lock(lock, sl);
@@ -545,21 +571,28 @@ RCLConsensus::Adaptor::doAccept(
                 // Stuff the ledger with transactions from the queue.
                 return app_.getTxQ().accept(app_, view);
             });
-
-        // Signal a potential fee change to subscribers after the open ledger
-        // is created
-        app_.getOPs().reportFeeChange();
+        closePipeline_.add(LedgerClosePipeline::open, openStart);
     }
 
     //-------------------------------------------------------------------------
     {
-        ledgerMaster_.switchLCL(sharedLCL.ledger_);
+        ledgerMaster_.setLCL(sharedLCL.ledger_);
 
         // Do these need to exist?
         assert(ledgerMaster_.getClosedLedger()->info().hash == sharedLCL.id());
         assert(
             app_.openLedger().current()->info().parentHash == sharedLCL.id());
     }
+    closePipeline_.add(LedgerClosePipeline::blackout, acceptStart);
+
+    // The next open ledger is available; the rest can lag behind
+    closePipeline_.post([this, closed = sharedLCL.ledger_]() {
+        ledgerMaster_.finishLCL(closed);
+
+        // Signal a potential fee change to subscribers after the open ledger
+        // is created
+        app_.getOPs().reportFeeChange();
+    });
 
     //-------------------------------------------------------------------------
     // we entered the round with the network,
@@ -684,6 +717,11 @@ applyTransactions(
         }
     }
 
+    // Optionally speculate on several threads; the result is identical
+    boost::optional<ParallelApply> parallel;
+    if (app.config().APPLY_THREADS > 1)
+        parallel.emplace(app, app.config().APPLY_THREADS, j);
+
     bool certainRetry = true;
     // Attempt to apply all of the retriable transactions
     for (int pass = 0; pass < LEDGER_TOTAL_PASSES; ++pass)
@@ -692,32 +730,40 @@ applyTransactions(
                         << (certainRetry ? " retriable" : " final");
         int changes = 0;
 
-        auto it = retriableTxs.begin();
-
-        while (it != retriableTxs.end())
+        if (parallel)
         {
-            try
+            changes = parallel->pass(view, retriableTxs, certainRetry,
+                tapNO_CHECK_SIGN | tapForConsensus);
+        }
+        else
+        {
+            auto it = retriableTxs.begin();
+
+            while (it != retriableTxs.end())
             {
-                switch (applyTransaction(
-                    app, view, *it->second, certainRetry, tapNO_CHECK_SIGN | tapForConsensus, j))
+                try
                 {
-                    case ApplyResult::Success:
-                        it = retriableTxs.erase(it);
-                        ++changes;
-                        break;
-
-                    case ApplyResult::Fail:
-                        it = retriableTxs.erase(it);
-                        break;
-
-                    case ApplyResult::Retry:
-                        ++it;
+                    switch (applyTransaction(
+                        app, view, *it->second, certainRetry, tapNO_CHECK_SIGN | tapForConsensus, j))
+                    {
+                        case ApplyResult::Success:
+                            it = retriableTxs.erase(it);
+                            ++changes;
+                            break;
+
+                        case ApplyResult::Fail:
+                            it = retriableTxs.erase(it);
+                            break;
+
+                        case ApplyResult::Retry:
+                            ++it;
+                    }
+                }
+                catch (std::exception const&)
+                {
+                    JLOG(j.warn()) << "Transaction throws";
+                    it = retriableTxs.erase(it);
                 }
-            }
-            catch (std::exception const&)
-            {
-                JLOG(j.warn()) << "Transaction throws";
-                it = retriableTxs.erase(it);
             }
         }
 
@@ -749,6 +795,9 @@ RCLConsensus::Adaptor::buildLCL(
     std::chrono::milliseconds roundTime,
     CanonicalTXSet& retriableTxs)
 {
+    using clock_type = LedgerClosePipeline::clock_type;
+    auto start = clock_type::now();
+
     auto replay = ledgerMaster_.releaseReplay();
     if (replay)
     {
@@ -801,6 +850,17 @@ RCLConsensus::Adaptor::buildLCL(
                 app_, set, accum, [&buildLCL](uint256 const& txID) {
                     return !buildLCL->txExists(txID);
                 });
+
+            // Track how fast we apply, for adaptive close timing
+            auto const elapsed = std::chrono::duration_cast<
+                std::chrono::microseconds>(clock_type::now() - start);
+            if (accum.txCount() != 0 && elapsed.count() > 0)
+            {
+                std::uint64_t const rate =
+                    accum.txCount() * 1000000ull / elapsed.count();
+                auto const prior = applyRate_.load();
+                applyRate_ = prior ? (3 * prior + rate) / 4 : rate;
+            }
         }
         // Update fee computations.
         app_.getTxQ().processClosedLedger(app_, accum, roundTime > 5s);
@@ -812,8 +872,11 @@ RCLConsensus::Adaptor::buildLCL(
     // to the ledger.
 
     buildLCL->updateSkipList();
+    closePipeline_.add(LedgerClosePipeline::build, start);
 
     {
+        start = clock_type::now();
+
         // Write the final version of all modified SHAMap
         // nodes to the node store to preserve the new LCL
 
@@ -823,7 +886,9 @@ RCLConsensus::Adaptor::buildLCL(
             hotTRANSACTION_NODE, buildLCL->info().seq);
         JLOG(j_.debug()) << "Flushed " << asf << " accounts and " << tmf
                          << " transaction nodes";
+        closePipeline_.add(LedgerClosePipeline::flush, start);
     }
+    start = clock_type::now();
     buildLCL->unshare();
 
     // Accept ledger
@@ -837,6 +902,7 @@ RCLConsensus::Adaptor::buildLCL(
         JLOG(j_.debug()) << "Consensus built ledger we were acquiring";
     else
         JLOG(j_.debug()) << "Consensus built new ledger";
+    closePipeline_.add(LedgerClosePipeline::hash, start);
     return RCLCxLedger{std::move(buildLCL)};
 }
 
@@ -956,6 +1022,20 @@ RCLConsensus::peerProposal(
     return consensus_.peerProposal(now, newProposal);
 }
 
+std::vector<bool>
+RCLConsensus::peerProposals(
+    NetClock::time_point const& now,
+    std::vector<RCLCxPeerPos> const& newProposals)
+{
+    std::vector<bool> relay;
+    relay.reserve(newProposals.size());
+
+    ScopedLockType _{mutex_};
+    for (auto const& newProposal : newProposals)
+        relay.push_back(consensus_.peerProposal(now, newProposal));
+    return relay;
+}
+
 bool
 RCLConsensus::Adaptor::preStartRound(RCLCxLedger const & prevLgr)
 {
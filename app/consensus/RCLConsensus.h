@@ -24,6 +24,7 @@
 #include <ripple/app/consensus/RCLCxLedger.h>
 #include <ripple/app/consensus/RCLCxPeerPos.h>
 #include <ripple/app/consensus/RCLCxTx.h>
+#include <ripple/app/ledger/LedgerClosePipeline.h>
 #include <ripple/app/misc/FeeVote.h>
 #include <ripple/basics/CountedObject.h>
 #include <ripple/basics/Log.h>
@@ -36,6 +37,7 @@
 #include <ripple/shamap/SHAMap.h>
 #include <atomic>
 #include <mutex>
+#include <vector>
 
 namespace ripple {
 
@@ -57,6 +59,7 @@ class RCLConsensus
         LocalTxs& localTxs_;
         InboundTransactions& inboundTransactions_;
         beast::Journal j_;
+        LedgerClosePipeline closePipeline_;
 
         NodeID const nodeID_;
         PublicKey const valPublic_;
@@ -77,6 +80,9 @@ class RCLConsensus
             std::chrono::milliseconds{0}};
         std::atomic<ConsensusMode> mode_{ConsensusMode::observing};
 
+        // Transactions per second applied building recent ledgers
+        std::atomic<std::uint64_t> applyRate_{0};
+
     public:
         using Ledger_t = RCLCxLedger;
         using NodeID_t = NodeID;
@@ -190,6 +196,13 @@ class RCLConsensus
         bool
         hasOpenTransactions() const;
 
+        /** Transactions in the open ledger and the TxQ, and how many
+            can be applied in parms().ledgerMIN_CLOSE at the rate the
+            last consensus sets were applied.
+         */
+        ConsensusBacklog
+        openBacklog() const;
+
         /** Number of proposers that have vallidated the given ledger
 
             @param h The hash of the ledger of interest
@@ -456,6 +469,16 @@ public:
         NetClock::time_point const& now,
         RCLCxPeerPos const& newProposal);
 
+    /** Process a batch of peer proposals under one lock
+
+        @return Whether each proposal should be relayed, in order
+        @see Consensus::peerProposal
+    */
+    std::vector<bool>
+    peerProposals(
+        NetClock::time_point const& now,
+        std::vector<RCLCxPeerPos> const& newProposals);
+
     ConsensusParms const &
     parms() const
     {
@@ -174,76 +174,118 @@ handleNewValidation(Application& app,
     STValidation::ref val,
     std::string const& source)
 {
-    PublicKey const& signer = val->getSignerPublic();
-    uint256 const& hash = val->getLedgerHash();
+    return handleNewValidations(app, {{val, source}}).front();
+}
+
+std::vector<bool>
+handleNewValidations(Application& app,
+    std::vector<std::pair<STValidation::pointer, std::string>> const& vals)
+{
+    using AddOutcome = RCLValidations::AddOutcome;
 
-    // Ensure validation is marked as trusted if signer currently trusted
-    boost::optional<PublicKey> pubKey = app.validators().getTrustedKey(signer);
-    if (!val->isTrusted() && pubKey)
-        val->setTrusted();
     RCLValidations& validations  = app.getValidations();
 
     beast::Journal j = validations.journal();
 
-    // Do not process partial validations.
-    if (!val->isFull())
-    {
-        const bool current = isCurrent(
-            validations.parms(),
-            app.timeKeeper().closeTime(),
-            val->getSignTime(),
-            val->getSeenTime());
-
-        JLOG(j.debug()) << "Val (partial) for " << hash << " from "
-                         << toBase58(TokenType::TOKEN_NODE_PUBLIC, signer)
-                         << " ignored "
-                         << (val->isTrusted() ? "trusted/" : "UNtrusted/")
-                         << (current ? "current" : "stale");
-
-        // Only forward if current and trusted
-        return current && val->isTrusted();
-    }
+    std::vector<bool> shouldRelay(vals.size(), false);
+
+    // The validations to add, and the index of each in vals
+    std::vector<std::pair<PublicKey, RCLValidation>> adds;
+    std::vector<std::size_t> indexes;
 
-    if (!val->isTrusted())
+    for (std::size_t i = 0; i < vals.size(); ++i)
     {
-        JLOG(j.trace()) << "Node "
+        STValidation::ref val = vals[i].first;
+        std::string const& source = vals[i].second;
+
+        PublicKey const& signer = val->getSignerPublic();
+        uint256 const& hash = val->getLedgerHash();
+
+        // Ensure validation is marked as trusted if signer currently trusted
+        boost::optional<PublicKey> pubKey =
+            app.validators().getTrustedKey(signer);
+        if (!val->isTrusted() && pubKey)
+            val->setTrusted();
+
+        // Do not process partial validations.
+        if (!val->isFull())
+        {
+            const bool current = isCurrent(
+                validations.parms(),
+                app.timeKeeper().closeTime(),
+                val->getSignTime(),
+                val->getSeenTime());
+
+            JLOG(j.debug()) << "Val (partial) for " << hash << " from "
+                             << toBase58(TokenType::TOKEN_NODE_PUBLIC, signer)
+                             << " ignored "
+                             << (val->isTrusted() ? "trusted/" : "UNtrusted/")
+                             << (current ? "current" : "stale");
+
+            // Only forward if current and trusted
+            shouldRelay[i] = current && val->isTrusted();
+            continue;
+        }
+
+        if (!val->isTrusted())
+        {
+            JLOG(j.trace()) << "Node "
+                            << toBase58(TokenType::TOKEN_NODE_PUBLIC, signer)
+                            << " not in UNL st="
+                            << val->getSignTime().time_since_epoch().count()
+                            << ", hash=" << hash
+                            << ", shash=" << val->getSigningHash()
+                            << " src=" << source;
+        }
+
+        // If not currently trusted, see if signer is currently listed
+        if (!pubKey)
+            pubKey = app.validators().getListedKey(signer);
+
+        // only add trusted or listed
+        if (pubKey)
+        {
+            adds.emplace_back(*pubKey, RCLValidation{val});
+            indexes.push_back(i);
+        }
+        else
+        {
+            JLOG(j.debug()) << "Val for " << hash << " from "
                         << toBase58(TokenType::TOKEN_NODE_PUBLIC, signer)
-                        << " not in UNL st="
-                        << val->getSignTime().time_since_epoch().count()
-                        << ", hash=" << hash
-                        << ", shash=" << val->getSigningHash()
-                        << " src=" << source;
+                        << " not added UNtrusted/";
+        }
     }
 
-    // If not currently trusted, see if signer is currently listed
-    if (!pubKey)
-        pubKey = app.validators().getListedKey(signer);
+    if (adds.empty())
+        return shouldRelay;
 
-    bool shouldRelay = false;
+    auto const results = validations.add(adds);
 
-    // only add trusted or listed
-    if (pubKey)
+    for (std::size_t k = 0; k < adds.size(); ++k)
     {
-        using AddOutcome = RCLValidations::AddOutcome;
-
-        AddOutcome const res = validations.add(*pubKey, val);
+        auto const i = indexes[k];
+        STValidation::ref val = vals[i].first;
+        AddOutcome const res = results[k];
+        uint256 const& hash = val->getLedgerHash();
 
         // This is a duplicate validation
         if (res == AddOutcome::repeat)
-            return false;
+            continue;
 
         // This validation replaced a prior one with the same sequence number
         if (res == AddOutcome::sameSeq)
         {
             auto const seq = val->getFieldU32(sfLedgerSequence);
             JLOG(j.warn()) << "Trusted node "
-                           << toBase58(TokenType::TOKEN_NODE_PUBLIC, *pubKey)
+                           << toBase58(TokenType::TOKEN_NODE_PUBLIC,
+                                  adds[k].first)
                            << " published multiple validations for ledger "
                            << seq;
         }
 
         JLOG(j.debug()) << "Val for " << hash << " from "
-                    << toBase58(TokenType::TOKEN_NODE_PUBLIC, signer)
+                    << toBase58(TokenType::TOKEN_NODE_PUBLIC,
+                           val->getSignerPublic())
                     << " added "
                     << (val->isTrusted() ? "trusted/" : "UNtrusted/")
                     << ((res == AddOutcome::current) ? "current" : "stale");
@@ -257,15 +299,9 @@ handleNewValidation(Application& app,
             app.getLedgerMaster().checkAccept(
                 hash, val->getFieldU32(sfLedgerSequence));
 
-            shouldRelay = true;
+            shouldRelay[i] = true;
         }
     }
-    else
-    {
-        JLOG(j.debug()) << "Val for " << hash << " from "
-                    << toBase58(TokenType::TOKEN_NODE_PUBLIC, signer)
-                    << " not added UNtrusted/";
-    }
 
     // This currently never forwards untrusted validations, though we may
     // reconsider in the future. From @JoelKatz:
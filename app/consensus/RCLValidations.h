@@ -24,6 +24,8 @@
 #include <ripple/consensus/Validations.h>
 #include <ripple/protocol/Protocol.h>
 #include <ripple/protocol/STValidation.h>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace ripple {
@@ -187,6 +189,21 @@ using RCLValidations =
 bool
 handleNewValidation(Application & app, STValidation::ref val, std::string const& source);
 
+/** Handle a batch of new validations
+
+    Equivalent to calling handleNewValidation on each element in order,
+    but the validations are added with a single acquisition of the
+    RCLValidations lock.
+
+    @param app Application object containing validations and ledgerMaster
+    @param vals Each validation, with the name used for it in logging
+
+    @return Whether each validation should be relayed, in the same order
+*/
+std::vector<bool>
+handleNewValidations(Application & app,
+    std::vector<std::pair<STValidation::pointer, std::string>> const& vals);
+
 
 }  // namespace ripple
 
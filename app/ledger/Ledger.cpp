@@ -28,6 +28,8 @@
 #include <ripple/app/ledger/PendingSaves.h>
 #include <ripple/app/ledger/TransactionMaster.h>
 #include <ripple/app/main/Application.h>
+#include <ripple/app/main/DBInit.h>
+#include <ripple/app/misc/AccountHistory.h>
 #include <ripple/app/misc/HashRouter.h>
 #include <ripple/app/misc/LoadFeeTrack.h>
 #include <ripple/app/misc/NetworkOPs.h>
@@ -458,9 +460,10 @@ Ledger::read (Keylet const& k) const
         stateMap_->peekItem(k.key);
     if (! item)
         return nullptr;
+    // The item is immutable, so the entry can refer to
+    // its bytes and parse only the fields callers touch.
     auto sle = std::make_shared<SLE>(
-        SerialIter{item->data(),
-            item->size()}, item->key());
+        item, item->slice(), item->key());
     if (! k.check(*sle))
         return nullptr;
     // need move otherwise makes a copy
@@ -814,6 +817,39 @@ void Ledger::updateSkipList ()
         rawReplace(sle);
 }
 
+namespace {
+
+// The rows one ledger adds to the transaction database. They are
+// built before the database is checked out, so that one save can
+// prepare its rows while another is writing.
+struct SaveRows
+{
+    // TransID and Account keys, see txnDBKey
+    struct Tx
+    {
+        std::shared_ptr<STTx const> txn;
+        Blob id;
+        std::string type;
+        std::string from;
+        std::uint32_t fromSeq;
+        std::uint32_t txnSeq;
+        Blob raw;
+        Blob meta;
+    };
+
+    struct Account
+    {
+        std::size_t tx;
+        AccountID account;
+        Blob key;
+    };
+
+    std::vector<Tx> txs;
+    std::vector<Account> accounts;
+};
+
+} // namespace
+
 static bool saveValidatedLedger (
     Application& app,
     std::shared_ptr<Ledger const> const& ledger,
@@ -828,20 +864,11 @@ static bool saveValidatedLedger (
         return true;
     }
 
-    // TODO(tom): Fix this hard-coded SQL!
+    auto const start = std::chrono::steady_clock::now();
+
     JLOG (j.trace())
         << "saveValidatedLedger "
         << (current ? "" : "fromAcquire ") << ledger->info().seq;
-    static boost::format deleteLedger (
-        "DELETE FROM Ledgers WHERE LedgerSeq = %u;");
-    static boost::format deleteTrans1 (
-        "DELETE FROM Transactions WHERE LedgerSeq = %u;");
-    static boost::format deleteTrans2 (
-        "DELETE FROM AccountTransactions WHERE LedgerSeq = %u;");
-    static boost::format deleteAcctTrans (
-        "DELETE FROM AccountTransactions WHERE TransID = '%s';");
-    static boost::format deleteTrans3(
-        "DELETE FROM TraceTransactions WHERE LedgerSeq = %u;");
 
     auto seq = ledger->info().seq;
 
@@ -872,6 +899,22 @@ static bool saveValidatedLedger (
             hotLEDGER, std::move (s.modData ()), ledger->info().hash);
     }
 
+    // Holds a PendingSaves write slot until the rows are written
+    struct WriteSlot
+    {
+        PendingSaves& saves;
+
+        explicit WriteSlot (PendingSaves& s)
+            : saves (s)
+        {
+            saves.beginWrite ();
+        }
+
+        ~WriteSlot ()
+        {
+            saves.endWrite ();
+        }
+    } slot (app.pendingSaves ());
 
     AcceptedLedger::pointer aLedger;
     try
@@ -893,9 +936,57 @@ static bool saveValidatedLedger (
         return false;
     }
 
+    auto const version = app.getTxnDBVersion ();
+
+    SaveRows rows;
+    rows.txs.reserve (aLedger->getMap ().size ());
+    for (auto const& vt : aLedger->getMap ())
+    {
+        auto const& txn = vt.second->getTxn ();
+        uint256 const transactionID = vt.second->getTransactionID ();
+
+        app.getMasterTransaction ().inLedger (
+            transactionID, seq);
+
+        auto const format =
+            TxFormats::getInstance().findByType (txn->getTxnType ());
+        assert (format != nullptr);
+
+        SaveRows::Tx tx;
+        tx.txn = txn;
+        tx.id = txnDBKey (version, transactionID);
+        tx.type = format->getName ();
+        tx.from = app.accountIDCache().toBase58 (
+            txn->getAccountID (sfAccount));
+        tx.fromSeq = txn->getSequence ();
+        tx.txnSeq = vt.second->getTxnSeq ();
+        {
+            Serializer s;
+            txn->add (s);
+            tx.raw = std::move (s.modData ());
+        }
+        tx.meta = vt.second->getRawMeta ();
+
+        auto const& accts = vt.second->getAffected ();
+        if (accts.empty ())
+        {
+            JLOG (j.warn())
+                << "Transaction in ledger " << seq
+                << " affects no accounts";
+            JLOG (j.warn())
+                << txn->getJson(0);
+        }
+        for (auto const& account : accts)
+            rows.accounts.push_back ({rows.txs.size (), account,
+                txnDBKey (version, account, app.accountIDCache ())});
+
+        rows.txs.push_back (std::move (tx));
+    }
+
     {
         auto db = app.getLedgerDB ().checkoutDb();
-        *db << boost::str (deleteLedger % seq);
+        *db << "DELETE FROM Ledgers WHERE LedgerSeq = :seq;",
+            soci::use(seq);
     }
 
     {
@@ -903,77 +994,96 @@ static bool saveValidatedLedger (
 
         soci::transaction tr(*db);
 
-        *db << boost::str (deleteTrans1 % seq);
-        *db << boost::str (deleteTrans2 % seq);
-        *db << boost::str (deleteTrans3 % seq);
+        *db << "DELETE FROM Transactions WHERE LedgerSeq = :seq;",
+            soci::use(seq);
+        *db << "DELETE FROM AccountTransactions WHERE LedgerSeq = :seq;",
+            soci::use(seq);
+        *db << "DELETE FROM TraceTransactions WHERE LedgerSeq = :seq;",
+            soci::use(seq);
+
+        // Each statement is prepared once and executed per row
+        // with the bound values below. The keys are bound as blobs
+        // and cast back to text for a database still using text keys.
+        auto const key = [version](std::string const& name)
+        {
+            if (version >= TxnDBVersion)
+                return name;
+            return "CAST(" + name + " AS TEXT)";
+        };
+
+        soci::blob txnId (*db);
+        std::string txnType;
+        std::string fromAcct;
+        std::uint32_t fromSeq = 0;
+        std::string const status (1, TXN_SQL_VALIDATED);
+        soci::blob rawTxn (*db);
+        soci::blob txnMeta (*db);
+        soci::blob account (*db);
+        std::uint32_t txnSeq = 0;
+
+        soci::statement deleteAcctTrans = (db->prepare <<
+            "DELETE FROM AccountTransactions WHERE TransID = " +
+                key (":txnId") + ";",
+            soci::use(txnId));
+
+        soci::statement insertAcctTrans = (db->prepare <<
+            "INSERT OR REPLACE INTO AccountTransactions "
+            "(TransID, Account, LedgerSeq, TxnSeq) VALUES (" +
+                key (":txnId") + ", " + key (":account") +
+                ", :ledgerSeq, :txnSeq);",
+            soci::use(txnId),
+            soci::use(account),
+            soci::use(seq),
+            soci::use(txnSeq));
+
+        soci::statement insertTrans = (db->prepare <<
+            "INSERT OR REPLACE INTO Transactions "
+            "(TransID, TransType, FromAcct, FromSeq, LedgerSeq, "
+            "Status, RawTxn, TxnMeta) VALUES (" + key (":txnId") +
+                ", :txnType, :fromAcct, :fromSeq, :ledgerSeq, "
+                ":status, :rawTxn, :txnMeta);",
+            soci::use(txnId),
+            soci::use(txnType),
+            soci::use(fromAcct),
+            soci::use(fromSeq),
+            soci::use(seq),
+            soci::use(status),
+            soci::use(rawTxn),
+            soci::use(txnMeta));
 
-        std::string const ledgerSeq (std::to_string (seq));
+        for (auto const& tx : rows.txs)
+        {
+            txnId.trim (0);
+            convert (tx.id, txnId);
+            deleteAcctTrans.execute (true);
+        }
+
+        for (auto const& row : rows.accounts)
+        {
+            auto const& tx = rows.txs[row.tx];
+            txnId.trim (0);
+            convert (tx.id, txnId);
+            account.trim (0);
+            convert (row.key, account);
+            txnSeq = tx.txnSeq;
+            insertAcctTrans.execute (true);
+        }
 
         std::uint64_t iTxSeq = uint64_t(seq) * 100000;
-        for (auto const& vt : aLedger->getMap ())
+        for (auto const& tx : rows.txs)
         {
-            uint256 transactionID = vt.second->getTransactionID ();
-
-            app.getMasterTransaction ().inLedger (
-                transactionID, seq);
-
-            std::string const txnId (to_string (transactionID));
-            std::string const txnSeq (std::to_string (vt.second->getTxnSeq ()));
-
-            *db << boost::str (deleteAcctTrans % transactionID);
-
-            auto const& accts = vt.second->getAffected ();
-
-            if (!accts.empty ())
-            {
-                std::string sql (
-                    "INSERT INTO AccountTransactions "
-                    "(TransID, Account, LedgerSeq, TxnSeq) VALUES ");
-
-                // Try to make an educated guess on how much space we'll need
-                // for our arguments. In argument order we have:
-                // 64 + 34 + 10 + 10 = 118 + 10 extra = 128 bytes
-                sql.reserve (sql.length () + (accts.size () * 128));
-
-                bool first = true;
-                for (auto const& account : accts)
-                {
-                    if (!first)
-                        sql += ", ('";
-                    else
-                    {
-                        sql += "('";
-                        first = false;
-                    }
-
-                    sql += txnId;
-                    sql += "','";
-                    sql += app.accountIDCache().toBase58(account);
-                    sql += "',";
-                    sql += ledgerSeq;
-                    sql += ",";
-                    sql += txnSeq;
-                    sql += ")";
-                }
-                sql += ";";
-                JLOG (j.trace()) << "ActTx: " << sql;
-                *db << sql;
-            }
-            else
-            {
-                JLOG (j.warn())
-                    << "Transaction in ledger " << seq
-                    << " affects no accounts";
-                JLOG (j.warn())
-                    << vt.second->getTxn()->getJson(0);
-            }
-
-            *db <<
-               (STTx::getMetaSQLInsertReplaceHeader () +
-                vt.second->getTxn ()->getMetaSQL (
-                    seq, vt.second->getEscMeta ()) + ";");
-                        
-            storePeersafeSql(db, vt.second->getTxn(), iTxSeq, seq,app);
+            txnId.trim (0);
+            convert (tx.id, txnId);
+            txnType = tx.type;
+            fromAcct = tx.from;
+            fromSeq = tx.fromSeq;
+            rawTxn.trim (0);
+            convert (tx.raw, rawTxn);
+            txnMeta.trim (0);
+            convert (tx.meta, txnMeta);
+            insertTrans.execute (true);
+
+            storePeersafeSql(db, tx.txn, iTxSeq, seq, app);
 
             iTxSeq++;
         }
@@ -981,6 +1091,19 @@ static bool saveValidatedLedger (
         tr.commit ();
     }
 
+    if (auto history = app.getAccountHistory ())
+    {
+        std::vector<AccountHistory::Entry> entries;
+        entries.reserve (rows.txs.size ());
+        for (auto& tx : rows.txs)
+            entries.push_back ({tx.txnSeq,
+                std::move (tx.raw), std::move (tx.meta), {}});
+        for (auto const& row : rows.accounts)
+            entries[row.tx].accounts.push_back (row.account);
+
+        history->saveLedger (seq, entries);
+    }
+
     {
         static std::string addLedger(
             R"sql(INSERT OR REPLACE INTO Ledgers
@@ -1031,6 +1154,10 @@ static bool saveValidatedLedger (
         tr.commit();
     }
 
+    app.getLedgerMaster().savedLedger (seq,
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start));
+
     // Clients can now trust the database for
     // information about this ledger sequence.
     app.pendingSaves().finishWork(seq);
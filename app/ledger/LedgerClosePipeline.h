@@ -0,0 +1,137 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_APP_LEDGER_LEDGERCLOSEPIPELINE_H_INCLUDED
+#define RIPPLE_APP_LEDGER_LEDGERCLOSEPIPELINE_H_INCLUDED
+
+#include <ripple/app/main/Application.h>
+#include <ripple/beast/insight/Collector.h>
+#include <ripple/beast/insight/Event.h>
+#include <ripple/beast/utility/Journal.h>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+namespace ripple {
+
+/** The stages of closing a ledger, and the work that may lag behind.
+
+    A consensus close builds the new last closed ledger, hashes it and
+    opens the next ledger on top of it. Until then, submitted
+    transactions can only go into the ledger being closed, so those
+    stages run on the accepting thread. Bookkeeping that only needs the
+    closed ledger, such as advancing the validated ledger and notifying
+    subscribers, is posted here instead. It runs in order on a single
+    job, after the next open ledger is available.
+
+    At most `maxPending` closes may be waiting; posting more blocks
+    until the oldest finishes, so a slow stage delays the closes behind
+    it instead of queuing without bound.
+
+    Each stage's duration is reported through beast::insight as a
+    "ledger_close_<stage>" event.
+
+    Thread safety:
+        All members may be called concurrently.
+*/
+class LedgerClosePipeline
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    enum Stage
+    {
+        /** Applying the consensus transactions to the new ledger */
+        build,
+
+        /** Writing the new ledger's modified nodes to the node store */
+        flush,
+
+        /** Computing the ledger hash and storing the ledger */
+        hash,
+
+        /** Building the next open ledger */
+        open,
+
+        /** From accepting consensus until the next open ledger exists */
+        blackout,
+
+        /** Time posted work waited before it ran */
+        wait,
+
+        /** Running posted work */
+        bookkeeping,
+
+        stageCount
+    };
+
+    /** The most closes whose posted work may be waiting. */
+    static std::size_t const maxPending = 4;
+
+    LedgerClosePipeline (Application& app,
+        beast::insight::Collector::ptr const& collector,
+        beast::Journal journal);
+
+    LedgerClosePipeline (LedgerClosePipeline const&) = delete;
+    LedgerClosePipeline& operator= (LedgerClosePipeline const&) = delete;
+
+    /** Record a stage that started at `start` and ended now. */
+    void
+    add (Stage stage, clock_type::time_point start);
+
+    /** Run `work` after the work posted before it.
+
+        In standalone mode, or once the job queue is stopping, the work
+        runs before this returns.
+    */
+    void
+    post (std::function<void()> work);
+
+private:
+    struct Work
+    {
+        std::function<void()> work;
+        clock_type::time_point posted;
+    };
+
+    void
+    run ();
+
+    void
+    runOne (Work& work);
+
+    Application& app_;
+    beast::Journal j_;
+    std::array<beast::insight::Event, stageCount> events_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Work> queue_;
+
+    // Whether a job is draining queue_
+    bool running_ = false;
+};
+
+} // ripple
+
+#endif
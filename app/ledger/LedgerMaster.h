@@ -145,8 +145,19 @@ public:
 
     void switchLCL (std::shared_ptr<Ledger const> const& lastClosed);
 
+    /** The two halves of switchLCL.
+
+        setLCL makes `lastClosed` the last closed ledger; finishLCL does
+        the bookkeeping that follows, and may be run later.
+    */
+    void setLCL (std::shared_ptr<Ledger const> const& lastClosed);
+    void finishLCL (std::shared_ptr<Ledger const> const& lastClosed);
+
     void failedSave(std::uint32_t seq, uint256 const& hash);
 
+    /** Report how long saving a validated ledger to SQL took. */
+    void savedLedger(std::uint32_t seq, std::chrono::milliseconds elapsed);
+
     std::string getCompleteLedgers ();
 
     /** Apply held transactions to the open ledger
@@ -333,6 +344,9 @@ private:
 
     LedgerHistory mLedgerHistory;
 
+    // Time taken by each saveValidatedLedger
+    beast::insight::Event mSaveLatency;
+
     CanonicalTXSet mHeldTransactions {uint256()};
 
     // A set of transactions to replay during the next close
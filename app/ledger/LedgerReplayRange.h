@@ -0,0 +1,57 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_APP_LEDGER_LEDGERREPLAYRANGE_H_INCLUDED
+#define RIPPLE_APP_LEDGER_LEDGERREPLAYRANGE_H_INCLUDED
+
+#include <ripple/app/main/Application.h>
+#include <ripple/json/json_value.h>
+#include <cstdint>
+
+namespace ripple {
+
+/** Rebuild a range of historical ledgers and time each step.
+
+    Each ledger from `first` to `last` is loaded from the ledger
+    database and the node store, and its transactions are applied in
+    their original order to the ledger before it, exactly as a
+    replayed consensus close would. The rebuilt ledger must hash to
+    the stored one; it is then flushed, and becomes the parent of
+    the next ledger. Only if `save` is set is it also saved to the
+    ledger and transaction databases, which rewrites their rows for
+    every replayed ledger.
+
+    The range is replayed `repeat` times. The first run starts with
+    whatever the caches hold after startup, later runs with the
+    caches warmed by the runs before them.
+
+    @return A report with ledgers/sec, transactions/sec, the time
+            spent loading, applying, flushing, hashing and saving,
+            and the cache hit rates of every run. The report has
+            "status" set to "success" only if every ledger matched.
+*/
+Json::Value
+replayLedgerRange (Application& app,
+    std::uint32_t first, std::uint32_t last, std::size_t repeat,
+    bool save);
+
+} // ripple
+
+#endif
@@ -24,9 +24,12 @@
 #include <ripple/ledger/CachedSLEs.h>
 #include <ripple/ledger/OpenView.h>
 #include <ripple/app/misc/CanonicalTXSet.h>
+#include <ripple/app/tx/applySteps.h>
 #include <ripple/basics/Log.h>
 #include <ripple/basics/UnorderedContainers.h>
 #include <ripple/core/Config.h>
+#include <ripple/beast/insight/Collector.h>
+#include <ripple/beast/insight/Event.h>
 #include <ripple/beast/utility/Journal.h>
 #include <cassert>
 #include <mutex>
@@ -54,6 +57,8 @@ private:
     std::mutex mutable modify_mutex_;
     std::mutex mutable current_mutex_;
     std::shared_ptr<OpenView const> current_;
+    // Time taken by accept() to build the new open view
+    beast::insight::Event rebuild_;
 
 public:
     /** Signature for modification functions.
@@ -82,7 +87,8 @@ public:
     OpenLedger(std::shared_ptr<
         Ledger const> const& ledger,
             CachedSLEs& cache,
-                beast::Journal journal);
+                beast::insight::Collector::ptr const& collector,
+                    beast::Journal journal);
 
     /** Returns `true` if there are no transactions.
 
@@ -156,6 +162,9 @@ public:
             The current view is atomically set to the
             new open view.
 
+            All candidate transactions are preflighted
+            in parallel before the rebuild starts.
+
         @param rules The rules for the open ledger
         @param ledger A new closed ledger
     */
@@ -168,6 +177,14 @@ public:
                         modify_type const& f = {});
 
 private:
+    /** Preflight results computed ahead of the rebuild.
+
+        Keyed by transaction ID. A result is only used when
+        it was made with the flags the transaction is applied
+        with.
+    */
+    using Preflights = hash_map<uint256, PreflightResult const*>;
+
     /** Algorithm for applying transactions.
 
         This has the retry logic and ordering semantics
@@ -180,7 +197,8 @@ private:
         ReadView const& check, FwdRange const& txs,
             OrderedTxs& retries, ApplyFlags flags,
                 std::map<uint256, bool>& shouldRecover,
-                    beast::Journal j);
+                    Preflights const& preflights,
+                        beast::Journal j);
 
     enum Result
     {
@@ -198,7 +216,8 @@ private:
     apply_one (Application& app, OpenView& view,
         std::shared_ptr< STTx const> const& tx,
             bool retry, ApplyFlags flags,
-                bool shouldRecover, beast::Journal j);
+                bool shouldRecover, Preflights const& preflights,
+                    beast::Journal j);
 };
 
 //------------------------------------------------------------------------------
@@ -209,7 +228,8 @@ OpenLedger::apply (Application& app, OpenView& view,
     ReadView const& check, FwdRange const& txs,
         OrderedTxs& retries, ApplyFlags flags,
             std::map<uint256, bool>& shouldRecover,
-                beast::Journal j)
+                Preflights const& preflights,
+                    beast::Journal j)
 {
     for (auto iter = txs.begin();
         iter != txs.end(); ++iter)
@@ -223,7 +243,7 @@ OpenLedger::apply (Application& app, OpenView& view,
             if (check.txExists(txId))
                 continue;
             auto const result = apply_one(app, view,
-                tx, true, flags, shouldRecover[txId], j);
+                tx, true, flags, shouldRecover[txId], preflights, j);
             if (result == Result::retry)
                 retries.insert(tx);
         }
@@ -244,7 +264,8 @@ OpenLedger::apply (Application& app, OpenView& view,
         {
             switch (apply_one(app, view,
                 iter->second, retry, flags,
-                    shouldRecover[iter->second->getTransactionID()], j))
+                    shouldRecover[iter->second->getTransactionID()],
+                        preflights, j))
             {
             case Result::success:
                 ++changes;
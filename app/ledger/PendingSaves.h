@@ -40,7 +40,13 @@ private:
     std::map <LedgerIndex, bool> map_;
     std::condition_variable await_;
 
+    // Saves past preparing their rows and not yet written
+    std::size_t writing_ = 0;
+    std::condition_variable writeSlot_;
+
 public:
+    /** The most saves that hold prepared rows at once */
+    static std::size_t const maxWriting = 4;
 
     /** Start working on a ledger
 
@@ -80,6 +86,29 @@ public:
         await_.notify_all();
     }
 
+    /** Wait until fewer than maxWriting saves are in progress
+
+        Called before a save prepares its rows, so that a burst of
+        saves does not hold the rows of every ledger in memory
+        while they queue for the database.
+    */
+    void
+    beginWrite ()
+    {
+        std::unique_lock <std::mutex> lock(mutex_);
+        writeSlot_.wait (lock, [this] { return writing_ < maxWriting; });
+        ++writing_;
+    }
+
+    /** Called when a save started with beginWrite is done. */
+    void
+    endWrite ()
+    {
+        std::lock_guard <std::mutex> lock(mutex_);
+        --writing_;
+        writeSlot_.notify_one();
+    }
+
     /** Return `true` if a ledger is in the progress of being saved. */
     bool
     pending (LedgerIndex seq)
@@ -0,0 +1,126 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/LedgerClosePipeline.h>
+#include <ripple/basics/Log.h>
+#include <ripple/core/Config.h>
+#include <ripple/core/JobQueue.h>
+#include <string>
+
+namespace ripple {
+
+static char const* const stageNames[LedgerClosePipeline::stageCount] =
+{
+    "build",
+    "flush",
+    "hash",
+    "open",
+    "blackout",
+    "wait",
+    "bookkeeping"
+};
+
+LedgerClosePipeline::LedgerClosePipeline (Application& app,
+        beast::insight::Collector::ptr const& collector,
+        beast::Journal journal)
+    : app_ (app)
+    , j_ (journal)
+{
+    for (std::size_t s = 0; s < stageCount; ++s)
+        events_[s] = collector->make_event (
+            std::string ("ledger_close_") + stageNames[s]);
+}
+
+void
+LedgerClosePipeline::add (Stage stage, clock_type::time_point start)
+{
+    auto const elapsed = std::chrono::duration_cast<
+        std::chrono::milliseconds> (clock_type::now() - start);
+    events_[stage].notify (elapsed);
+
+    JLOG (j_.debug()) << "Close stage " << stageNames[stage] <<
+        ": " << elapsed.count() << "ms";
+}
+
+void
+LedgerClosePipeline::post (std::function<void()> work)
+{
+    Work w {std::move (work), clock_type::now()};
+
+    if (app_.config().standalone())
+    {
+        // Callers such as ledger_accept expect the close to be
+        // complete when it returns.
+        runOne (w);
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock (mutex_);
+        cv_.wait (lock, [this] { return queue_.size () < maxPending; });
+
+        queue_.push_back (std::move (w));
+        if (running_)
+            return;
+        running_ = true;
+    }
+
+    if (app_.getJobQueue ().addJob (jtADVANCE, "LedgerClosePipeline",
+            [this] (Job&) { run (); }))
+        return;
+
+    // The job queue is stopping
+    run ();
+}
+
+void
+LedgerClosePipeline::run ()
+{
+    for (;;)
+    {
+        Work w;
+        {
+            std::lock_guard<std::mutex> lock (mutex_);
+            if (queue_.empty ())
+            {
+                running_ = false;
+                return;
+            }
+            w = std::move (queue_.front ());
+            queue_.pop_front ();
+        }
+        cv_.notify_all ();
+
+        runOne (w);
+    }
+}
+
+void
+LedgerClosePipeline::runOne (Work& w)
+{
+    add (wait, w.posted);
+
+    auto const start = clock_type::now();
+    w.work ();
+    add (bookkeeping, start);
+}
+
+} // ripple
@@ -74,6 +74,7 @@ LedgerMaster::LedgerMaster (Application& app, Stopwatch& stopwatch,
     , app_ (app)
     , m_journal (journal)
     , mLedgerHistory (collector, app)
+    , mSaveLatency (collector->make_event ("ledger_save"))
     , mLedgerCleaner (detail::make_LedgerCleaner (
         app, *this, app_.journal("LedgerCleaner")))
     , standalone_ (app_.config().standalone())
@@ -253,6 +254,13 @@ LedgerMaster::addHeldTransaction (
 
 void
 LedgerMaster::switchLCL(std::shared_ptr<Ledger const> const& lastClosed)
+{
+    setLCL (lastClosed);
+    finishLCL (lastClosed);
+}
+
+void
+LedgerMaster::setLCL(std::shared_ptr<Ledger const> const& lastClosed)
 {
     assert (lastClosed);
     if(! lastClosed->isImmutable())
@@ -261,11 +269,13 @@ LedgerMaster::switchLCL(std::shared_ptr<Ledger const> const& lastClosed)
     if (lastClosed->open())
         LogicError ("The new last closed ledger is open!");
 
-    {
-        ScopedLockType ml (m_mutex);
-        mClosedLedger.set (lastClosed);
-    }
+    ScopedLockType ml (m_mutex);
+    mClosedLedger.set (lastClosed);
+}
 
+void
+LedgerMaster::finishLCL(std::shared_ptr<Ledger const> const& lastClosed)
+{
     if (standalone_)
     {
         setFullLedger (lastClosed, true, false);
@@ -757,6 +767,14 @@ LedgerMaster::failedSave(std::uint32_t seq, uint256 const& hash)
         hash, seq, InboundLedger::fcGENERIC);
 }
 
+void
+LedgerMaster::savedLedger(std::uint32_t seq, std::chrono::milliseconds elapsed)
+{
+    JLOG (m_journal.debug()) << "Saved ledger " << seq
+        << " in " << elapsed.count() << "ms";
+    mSaveLatency.notify (elapsed);
+}
+
 // Check if the specified ledger can become the new last fully-validated
 // ledger.
 void
@@ -0,0 +1,269 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/LedgerReplayRange.h>
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/app/tx/apply.h>
+#include <ripple/basics/Log.h>
+#include <ripple/ledger/CachedSLEs.h>
+#include <ripple/ledger/OpenView.h>
+#include <ripple/nodestore/Database.h>
+#include <ripple/protocol/Feature.h>
+#include <ripple/protocol/JsonFields.h>
+#include <ripple/shamap/SHAMapMissingNode.h>
+#include <array>
+#include <chrono>
+#include <map>
+
+namespace ripple {
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+enum Phase
+{
+    phaseLoad,
+    phaseApply,
+    phaseFlush,
+    phaseHash,
+    phaseSave,
+
+    phaseCount
+};
+
+char const* const phaseNames[phaseCount] =
+{
+    "load",
+    "apply",
+    "flush",
+    "hash",
+    "save"
+};
+
+struct Run
+{
+    std::array<clock_type::duration, phaseCount> phases {};
+    std::size_t ledgers = 0;
+    std::size_t transactions = 0;
+    std::size_t mismatches = 0;
+};
+
+// Adds the time since `start` to `phase`, and restarts the clock
+void
+lap (Run& run, Phase phase, clock_type::time_point& start)
+{
+    auto const now = clock_type::now();
+    run.phases[phase] += now - start;
+    start = now;
+}
+
+// Build the ledger after `parent` from the transactions of `stored`,
+// the same way RCLConsensus::Adaptor::buildLCL replays a close.
+std::shared_ptr<Ledger>
+rebuild (Application& app, Run& run,
+    std::shared_ptr<Ledger const> const& parent,
+    std::shared_ptr<Ledger const> const& stored,
+    beast::Journal j)
+{
+    auto start = clock_type::now();
+
+    std::map<int, std::shared_ptr<STTx const>> txns;
+    for (auto const& item : stored->txMap())
+    {
+        auto const txPair = stored->txRead (item.key());
+        txns.emplace ((*txPair.second)[sfTransactionIndex], txPair.first);
+    }
+    lap (run, phaseLoad, start);
+
+    auto const& info = stored->info();
+    auto built = std::make_shared<Ledger> (*parent, info.closeTime);
+
+    auto const v2_enabled = built->rules().enabled(featureSHAMapV2);
+    auto const disablev2_enabled = built->rules().enabled(featureDisableV2);
+    if (disablev2_enabled && built->stateMap().is_v2())
+        built->make_v1();
+    else if (!disablev2_enabled && v2_enabled && !built->stateMap().is_v2())
+        built->make_v2();
+
+    {
+        OpenView accum (&*built);
+        for (auto const& tx : txns)
+            applyTransaction (app, accum, *tx.second, false,
+                tapNO_CHECK_SIGN | tapForConsensus, j);
+        accum.apply (*built);
+    }
+    built->updateSkipList ();
+    lap (run, phaseApply, start);
+
+    built->stateMap().flushDirty (hotACCOUNT_NODE, built->info().seq);
+    built->txMap().flushDirty (hotTRANSACTION_NODE, built->info().seq);
+    lap (run, phaseFlush, start);
+
+    built->unshare ();
+    built->setAccepted (info.closeTime, info.closeTimeResolution,
+        (info.closeFlags & sLCF_NoConsensusTime) == 0, app.config());
+    lap (run, phaseHash, start);
+
+    run.transactions += txns.size();
+    return built;
+}
+
+Json::Value
+report (Run const& run)
+{
+    using namespace std::chrono;
+
+    Json::Value ret = Json::objectValue;
+
+    clock_type::duration total {};
+    Json::Value& phases = ret["phases_ms"] = Json::objectValue;
+    for (std::size_t p = 0; p < phaseCount; ++p)
+    {
+        total += run.phases[p];
+        phases[phaseNames[p]] = static_cast<Json::UInt> (
+            duration_cast<milliseconds> (run.phases[p]).count());
+    }
+
+    auto const seconds = duration_cast<duration<double>> (total).count();
+    ret["ledgers"] = static_cast<Json::UInt> (run.ledgers);
+    ret["transactions"] = static_cast<Json::UInt> (run.transactions);
+    ret["mismatches"] = static_cast<Json::UInt> (run.mismatches);
+    ret["elapsed_ms"] = static_cast<Json::UInt> (
+        duration_cast<milliseconds> (total).count());
+    if (seconds > 0)
+    {
+        ret["ledgers_per_sec"] = run.ledgers / seconds;
+        ret["transactions_per_sec"] = run.transactions / seconds;
+    }
+    return ret;
+}
+
+} // namespace
+
+Json::Value
+replayLedgerRange (Application& app,
+    std::uint32_t first, std::uint32_t last, std::size_t repeat,
+    bool save)
+{
+    auto const j = app.journal ("LedgerReplay");
+
+    Json::Value ret = Json::objectValue;
+    ret["first"] = first;
+    ret["last"] = last;
+    ret["save"] = save;
+    Json::Value& runs = ret["runs"] = Json::arrayValue;
+
+    bool ok = first != 0 && first <= last;
+    for (std::size_t r = 0; ok && r < repeat; ++r)
+    {
+        Run run;
+        auto& db = app.getNodeStore();
+        auto const fetchTotal = db.getFetchTotalCount();
+        auto const fetchHits = db.getFetchHitCount();
+        auto const sleHits = app.cachedSLEs().hits();
+        auto const sleMisses = app.cachedSLEs().misses();
+        app.family().treecache().clearStats();
+
+        try
+        {
+            auto start = clock_type::now();
+            std::shared_ptr<Ledger const> parent =
+                loadByIndex (first - 1, app);
+            lap (run, phaseLoad, start);
+
+            for (auto seq = first; parent && seq <= last; ++seq)
+            {
+                start = clock_type::now();
+                std::shared_ptr<Ledger const> stored =
+                    loadByIndex (seq, app);
+                lap (run, phaseLoad, start);
+                if (! stored)
+                {
+                    JLOG (j.error()) << "Ledger " << seq << " not found";
+                    ok = false;
+                    break;
+                }
+
+                auto built = rebuild (app, run, parent, stored, j);
+                ++run.ledgers;
+
+                if (built->info().hash != stored->info().hash)
+                {
+                    JLOG (j.error()) << "Ledger " << seq <<
+                        " rebuilt as " << built->info().hash <<
+                        " (state " << built->info().accountHash <<
+                        ") expected " << stored->info().hash <<
+                        " (state " << stored->info().accountHash << ")";
+                    ++run.mismatches;
+                    ok = false;
+
+                    // Carry on from the stored ledger
+                    parent = stored;
+                    continue;
+                }
+
+                if (save)
+                {
+                    start = clock_type::now();
+                    pendSaveValidated (app, built, true, false);
+                    lap (run, phaseSave, start);
+                }
+
+                JLOG (j.debug()) << "Ledger " << seq << " matches";
+                parent = std::move (built);
+            }
+
+            if (! parent)
+            {
+                JLOG (j.error()) << "Ledger " << (first - 1) << " not found";
+                ok = false;
+            }
+        }
+        catch (SHAMapMissingNode const& e)
+        {
+            JLOG (j.error()) << "Replay is missing data: " << e.what();
+            ok = false;
+        }
+
+        auto jr = report (run);
+        auto const total = db.getFetchTotalCount() - fetchTotal;
+        auto const hits = db.getFetchHitCount() - fetchHits;
+        Json::Value& caches = jr["cache_hit_rate"] = Json::objectValue;
+        caches["node_store"] = total ? double (hits) / total : 0.0;
+        caches["tree_node"] =
+            app.family().treecache().getHitRate() / 100.0;
+        auto const sleHit = app.cachedSLEs().hits() - sleHits;
+        auto const sleTotal =
+            sleHit + app.cachedSLEs().misses() - sleMisses;
+        caches["cached_sles"] = sleTotal ? double (sleHit) / sleTotal : 0.0;
+        runs.append (jr);
+
+        JLOG (j.info()) << "Replay run " << r << ": " <<
+            run.ledgers << " ledgers, " << run.transactions <<
+            " transactions, " << run.mismatches << " mismatched";
+    }
+
+    ret[jss::status] = ok ? "success" : "error";
+    return ret;
+}
+
+} // ripple
@@ -35,10 +35,12 @@ namespace ripple {
 OpenLedger::OpenLedger(std::shared_ptr<
     Ledger const> const& ledger,
         CachedSLEs& cache,
-            beast::Journal journal)
+            beast::insight::Collector::ptr const& collector,
+                beast::Journal journal)
     : j_ (journal)
     , cache_ (cache)
     , current_ (create(ledger->rules(), ledger))
+    , rebuild_ (collector->make_event ("open_ledger_rebuild"))
 {
 }
 
@@ -87,6 +89,37 @@ OpenLedger::accept(Application& app, Rules const& rules,
 {
     JLOG(j_.trace()) <<
         "accept ledger " << ledger->seq() << " " << suffix;
+    auto const start = std::chrono::steady_clock::now();
+
+    // Preflight needs no ledger, so check every candidate in
+    // parallel before any of them is applied. Transactions that
+    // arrive in the open ledger after this snapshot, and those
+    // with effects outside the ledger, are preflighted when
+    // they are applied.
+    std::vector<std::pair<std::shared_ptr<STTx const>, ApplyFlags>> early;
+    {
+        auto const retryFlags = flags | tapRETRY | tapPREFER_QUEUE;
+        auto const add = [&early](
+            std::shared_ptr<STTx const> const& tx, ApplyFlags f)
+        {
+            if (tx->isAjmChainTableType() ||
+                STTx::checkAjmchainContractType(tx->getTxnType()))
+                return;
+            early.emplace_back (tx, f);
+        };
+        for (auto const& tx : retries)
+            add (tx.second, retryFlags);
+        for (auto const& tx : current()->txs)
+            add (tx.first, retryFlags);
+        for (auto const& item : locals)
+            add (item.second, flags);
+    }
+    auto const pfresults = preflightBatch (app, rules, early, j_);
+    Preflights preflights;
+    for (std::size_t i = 0; i < early.size(); ++i)
+        preflights.emplace (
+            early[i].first->getTransactionID(), &pfresults[i]);
+
     auto next = create(rules, ledger);
     std::map<uint256, bool> shouldRecover;
     if (retriesFirst)
@@ -101,7 +134,7 @@ OpenLedger::accept(Application& app, Rules const& rules,
             std::vector<std::shared_ptr<
                 STTx const>>;
         apply (app, *next, *ledger, empty{},
-            retries, flags, shouldRecover, j_);
+            retries, flags, shouldRecover, preflights, j_);
     }
     // Block calls to modify, otherwise
     // new tx going into the open ledger
@@ -132,15 +165,23 @@ OpenLedger::accept(Application& app, Rules const& rules,
             {
                 return p.first;
             }),
-                retries, flags, shouldRecover, j_);
+                retries, flags, shouldRecover, preflights, j_);
     }
     // Call the modifier
     if (f)
         f(*next, j_);
     // Apply local tx
     for (auto const& item : locals)
-        app.getTxQ().apply(app, *next,
-            item.second, flags, j_);
+    {
+        auto const pf = preflights.find(
+            item.second->getTransactionID());
+        if (pf != preflights.end() && pf->second->flags == flags)
+            app.getTxQ().apply(app, *next,
+                item.second, *pf->second, j_);
+        else
+            app.getTxQ().apply(app, *next,
+                item.second, flags, j_);
+    }
 
     // If we didn't relay this transaction recently, relay it to all peers
     for (auto const& txpair : next->txs)
@@ -165,9 +206,19 @@ OpenLedger::accept(Application& app, Rules const& rules,
     }
 
     // Switch to the new open view
-    std::lock_guard<
-        std::mutex> lock2(current_mutex_);
-    current_ = std::move(next);
+    {
+        std::lock_guard<
+            std::mutex> lock2(current_mutex_);
+        current_ = std::move(next);
+    }
+
+    auto const elapsed = std::chrono::duration_cast<
+        std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start);
+    rebuild_.notify (elapsed);
+    JLOG(j_.debug()) <<
+        "accept ledger " << ledger->seq() << " rebuilt open ledger in " <<
+            elapsed.count() << "ms, " << early.size() << " preflighted";
 }
 
 //------------------------------------------------------------------------------
@@ -186,14 +237,22 @@ auto
 OpenLedger::apply_one (Application& app, OpenView& view,
     std::shared_ptr<STTx const> const& tx,
         bool retry, ApplyFlags flags, bool shouldRecover,
-            beast::Journal j) -> Result
+            Preflights const& preflights, beast::Journal j) -> Result
 {
     if (retry)
         flags = flags | tapRETRY;
     auto const result = [&]
     {
-        auto const queueResult = app.getTxQ().apply(
-            app, view, tx, flags | tapPREFER_QUEUE, j);
+        auto const queueResult = [&]
+        {
+            // Reuse the early preflight if it had these flags
+            auto const pf = preflights.find(tx->getTransactionID());
+            if (pf != preflights.end() &&
+                    pf->second->flags == (flags | tapPREFER_QUEUE))
+                return app.getTxQ().apply(app, view, tx, *pf->second, j);
+            return app.getTxQ().apply(
+                app, view, tx, flags | tapPREFER_QUEUE, j);
+        }();
         // If the transaction can't get into the queue for intrinsic
         // reasons, and it can still be recovered, try to put it
         // directly into the open ledger, else drop it.
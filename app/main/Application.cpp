@@ -35,7 +35,10 @@
 #include <ripple/app/main/LoadManager.h>
 #include <ripple/app/main/NodeIdentity.h>
 #include <ripple/app/main/NodeStoreScheduler.h>
+#include <ripple/app/misc/AccountHistory.h>
 #include <ripple/app/misc/AmendmentTable.h>
+#include <ripple/app/misc/BatchVerifier.h>
+#include <ripple/app/tx/ApplyProfiler.h>
 #include <ripple/app/misc/HashRouter.h>
 #include <ripple/app/misc/LoadFeeTrack.h>
 #include <ripple/app/misc/NetworkOPs.h>
@@ -68,6 +71,7 @@
 #include <boost/asio/steady_timer.hpp>
 #include <boost/optional.hpp>
 #include <fstream>
+#include <map>
 #include <sstream>
 #include <iostream>
 
@@ -85,6 +89,7 @@ class AppFamily : public Family
 private:
     Application& app_;
     TreeNodeCache treecache_;
+    SerializedNodeCache serialcache_;
     FullBelowCache fullbelow_;
     NodeStore::Database& db_;
     beast::Journal j_;
@@ -118,6 +123,8 @@ public:
         : app_ (app)
         , treecache_ ("TreeNodeCache", 65536, 60, stopwatch(),
             app.journal("TaggedCache"))
+        , serialcache_ ("SerializedNodeCache", 65536, 60, stopwatch(),
+            app.journal("TaggedCache"))
         , fullbelow_ ("full_below", stopwatch(),
             collectorManager.collector(),
                 fullBelowTargetSize, fullBelowExpirationSeconds)
@@ -156,6 +163,18 @@ public:
         return treecache_;
     }
 
+    SerializedNodeCache&
+    serialcache() override
+    {
+        return serialcache_;
+    }
+
+    SerializedNodeCache const&
+    serialcache() const override
+    {
+        return serialcache_;
+    }
+
     NodeStore::Database&
     db() override
     {
@@ -343,6 +362,8 @@ public:
     std::unique_ptr <AmendmentTable> m_amendmentTable;
     std::unique_ptr <LoadFeeTrack> mFeeTrack;
     std::unique_ptr <HashRouter> mHashRouter;
+    std::unique_ptr <BatchVerifier> batchVerifier_;
+    std::unique_ptr <ApplyProfiler> applyProfiler_;
 	RCLValidations mValidations;
     std::unique_ptr <LoadManager> m_loadManager;
     std::unique_ptr <TxQ> txQ_;
@@ -360,8 +381,10 @@ public:
     bool startTimers_;
 
     std::unique_ptr <DatabaseCon> mTxnDB;
+    int txnDBVersion_ = 0;
     std::unique_ptr <DatabaseCon> mLedgerDB;
     std::unique_ptr <DatabaseCon> mWalletDB;
+    std::unique_ptr <AccountHistory> accountHistory_;
     std::unique_ptr <Overlay> m_overlay;
     std::vector <std::unique_ptr<Stoppable>> websocketServers_;
 
@@ -496,6 +519,12 @@ public:
             stopwatch(), HashRouter::getDefaultHoldTime (),
             HashRouter::getDefaultRecoverLimit ()))
 
+        , batchVerifier_ (std::make_unique<BatchVerifier>(
+            *this, logs_->journal("BatchVerifier")))
+
+        , applyProfiler_ (std::make_unique<ApplyProfiler>(
+            *m_collectorManager))
+
         , mValidations (ValidationParms(),stopwatch(), logs_->journal("Validations"),
             *this)
 
@@ -759,6 +788,16 @@ public:
         return *mHashRouter;
     }
 
+    BatchVerifier& getBatchVerifier () override
+    {
+        return *batchVerifier_;
+    }
+
+    ApplyProfiler& getApplyProfiler () override
+    {
+        return *applyProfiler_;
+    }
+
     RCLValidations& getValidations () override
     {
         return mValidations;
@@ -833,6 +872,14 @@ public:
         assert (mTxnDB.get() != nullptr);
         return *mTxnDB;
     }
+    int getTxnDBVersion () const override
+    {
+        return txnDBVersion_;
+    }
+    AccountHistory* getAccountHistory () override
+    {
+        return accountHistory_.get ();
+    }
     DatabaseCon& getLedgerDB () override
     {
         assert (mLedgerDB.get() != nullptr);
@@ -1079,6 +1126,7 @@ public:
         getTableSync().sweep();
         m_acceptedLedgerCache.sweep();
         family().treecache().sweep();
+        family().serialcache().sweep();
         cachedSLEs_.expire();
 
         // Set timer to do another sweep later.
@@ -1097,6 +1145,8 @@ private:
     std::atomic<LedgerIndex> maxDisallowedLedger_ {0};
 
     void addTxnSeqField();
+    int readTxnDBVersion();
+    void compactTxnTables();
     void addValidationSeqFields();
     bool updateTables ();
     void startGenesisLedger ();
@@ -1181,6 +1231,19 @@ bool ApplicationImp::setup()
     if (!updateTables ())
         return false;
 
+    try
+    {
+        accountHistory_ = make_AccountHistory (
+            config_->section (SECTION_ACCOUNT_HISTORY_DB),
+            logs_->journal ("AccountHistory"));
+    }
+    catch (std::exception const& e)
+    {
+        JLOG(m_journal.fatal()) << "Cannot open the account history: "
+            << e.what ();
+        return false;
+    }
+
     // Configure the amendments the server supports
     {
         Section supportedAmendments ("Supported Amendments");
@@ -1317,6 +1380,11 @@ bool ApplicationImp::setup()
     m_ledgerMaster->tune (config_->getSize (siLedgerSize), config_->getSize (siLedgerAge));
     family().treecache().setTargetSize (config_->getSize (siTreeCacheSize));
     family().treecache().setTargetAge (config_->getSize (siTreeCacheAge));
+    family().serialcache().setTargetSize (config_->getSize (siTreeCacheSize));
+    family().serialcache().setTargetAge (config_->getSize (siTreeCacheAge));
+    cachedSLEs_.setTargetBytes (config_->SLE_CACHE_MB
+        ? config_->SLE_CACHE_MB * 1024 * 1024
+        : std::size_t (config_->getSize (siSLECacheBytes)) * 1024);
 
     //----------------------------------------------------------------------
     //
@@ -1502,7 +1570,7 @@ ApplicationImp::startGenesisLedger()
 		hotACCOUNT_NODE, next->info().seq);
     next->setImmutable (*config_);
     openLedger_.emplace(next, cachedSLEs_,
-        logs_->journal("OpenLedger"));
+        m_collectorManager->collector(), logs_->journal("OpenLedger"));
     m_ledgerMaster->storeLedger(next);
     m_ledgerMaster->switchLCL (next);
 }
@@ -1816,7 +1884,7 @@ bool ApplicationImp::loadOldLedger (
         loadLedger->setValidated();
         m_ledgerMaster->setFullLedger(loadLedger, true, false);
         openLedger_.emplace(loadLedger, cachedSLEs_,
-            logs_->journal("OpenLedger"));
+            m_collectorManager->collector(), logs_->journal("OpenLedger"));
 
         if (replay)
         {
@@ -2040,6 +2108,258 @@ void ApplicationImp::addTxnSeqField ()
     tr.commit ();
 }
 
+int ApplicationImp::readTxnDBVersion ()
+{
+    auto& session = getTxnDB ().getSession ();
+
+    int version = 0;
+    session << "PRAGMA user_version;", soci::into (version);
+
+    // TxnDBInit creates the current schema in an empty database
+    if (version == 0 &&
+        schemaHas (getTxnDB (), "AccountTransactions", 0, "WITHOUT ROWID", m_journal))
+    {
+        version = TxnDBVersion;
+        session << "PRAGMA user_version = " << version << ";";
+    }
+
+    return version;
+}
+
+void ApplicationImp::compactTxnTables ()
+{
+    if (txnDBVersion_ >= TxnDBVersion)
+    {
+        JLOG (m_journal.info()) << "The transaction database already "
+            "uses binary keys";
+        return;
+    }
+
+    auto& session = getTxnDB ().getSession ();
+
+    JLOG (m_journal.warn()) << "Converting the transaction database to "
+        "binary keys; this needs free space for a second copy";
+
+    // The converted rows go to new tables, committed a range of
+    // ledgers at a time. An interrupted conversion resumes after
+    // the last range it committed, unless the server has written
+    // to the old tables since.
+    boost::optional<std::int64_t> txnRows;
+    boost::optional<std::int64_t> acctTxnRows;
+    session << "SELECT MAX(rowid) FROM Transactions;", soci::into (txnRows);
+    session << "SELECT MAX(rowid) FROM AccountTransactions;",
+        soci::into (acctTxnRows);
+
+    session << "CREATE TABLE IF NOT EXISTS CompactProgress (  \
+        TxnRowID        BIGINT,                 \
+        AcctTxnRowID    BIGINT                  \
+    );";
+
+    {
+        boost::optional<std::int64_t> doneTxnRows;
+        boost::optional<std::int64_t> doneAcctTxnRows;
+        session << "SELECT TxnRowID, AcctTxnRowID FROM CompactProgress;",
+            soci::into (doneTxnRows), soci::into (doneAcctTxnRows);
+
+        if (session.got_data () &&
+            (doneTxnRows != txnRows || doneAcctTxnRows != acctTxnRows))
+        {
+            JLOG (m_journal.warn()) << "The transaction tables changed since "
+                "the last conversion was interrupted, starting over";
+            session << "DROP TABLE IF EXISTS CompactTransactions;";
+            session << "DROP TABLE IF EXISTS CompactAccountTransactions;";
+        }
+
+        session << "DELETE FROM CompactProgress;";
+        session << "INSERT INTO CompactProgress (TxnRowID, AcctTxnRowID) "
+            "VALUES (:txnRows, :acctTxnRows);",
+            soci::use (txnRows), soci::use (acctTxnRows);
+    }
+
+    // These should be identical to those in TxnDBInit
+    session << "CREATE TABLE IF NOT EXISTS CompactTransactions (   \
+        TransID     BLOB PRIMARY KEY,           \
+        TransType   CHARACTER(24),              \
+        FromAcct    CHARACTER(35),              \
+        FromSeq     BIGINT UNSIGNED,            \
+        LedgerSeq   BIGINT UNSIGNED,            \
+        Status      CHARACTER(1),               \
+        RawTxn      BLOB,                       \
+        TxnMeta     BLOB                        \
+    );";
+    session << "CREATE TABLE IF NOT EXISTS CompactAccountTransactions ( \
+        Account     BLOB,                       \
+        LedgerSeq   BIGINT UNSIGNED,            \
+        TxnSeq      INTEGER,                    \
+        TransID     BLOB,                       \
+        PRIMARY KEY (Account, LedgerSeq, TxnSeq) \
+    ) WITHOUT ROWID;";
+
+    boost::optional<std::uint64_t> done;
+    boost::optional<std::uint64_t> first;
+    boost::optional<std::uint64_t> last;
+    session << "SELECT MAX(LedgerSeq) FROM CompactTransactions;",
+        soci::into (done);
+    session << "SELECT MIN(LedgerSeq), MAX(LedgerSeq) FROM Transactions;",
+        soci::into (first), soci::into (last);
+
+    std::uint64_t const ledgersPerBatch = 10000;
+    std::uint64_t lo = done ? *done + 1 : first.value_or (0);
+    std::uint64_t hi = 0;
+
+    boost::optional<std::string> transID;
+    boost::optional<std::string> transType;
+    boost::optional<std::string> fromAcct;
+    boost::optional<std::uint64_t> fromSeq;
+    boost::optional<std::uint64_t> ledgerSeq;
+    boost::optional<std::string> status;
+    boost::optional<std::string> account;
+    boost::optional<std::int64_t> txnSeq;
+    std::int64_t newTxnSeq = 0;
+    soci::blob rawTxn (session);
+    soci::blob txnMeta (session);
+    soci::blob transIDBlob (session);
+    soci::blob accountBlob (session);
+    soci::indicator rti, tmi;
+
+    soci::statement selectTrans = (session.prepare <<
+        "SELECT TransID, TransType, FromAcct, FromSeq, LedgerSeq, "
+        "Status, RawTxn, TxnMeta FROM Transactions "
+        "WHERE LedgerSeq BETWEEN :lo AND :hi;",
+        soci::into (transID), soci::into (transType),
+        soci::into (fromAcct), soci::into (fromSeq),
+        soci::into (ledgerSeq), soci::into (status),
+        soci::into (rawTxn, rti), soci::into (txnMeta, tmi),
+        soci::use (lo), soci::use (hi));
+
+    soci::statement insertTrans = (session.prepare <<
+        "INSERT OR REPLACE INTO CompactTransactions "
+        "(TransID, TransType, FromAcct, FromSeq, LedgerSeq, "
+        "Status, RawTxn, TxnMeta) VALUES "
+        "(:transID, :transType, :fromAcct, :fromSeq, :ledgerSeq, "
+        ":status, :rawTxn, :txnMeta);",
+        soci::use (transIDBlob), soci::use (transType),
+        soci::use (fromAcct), soci::use (fromSeq),
+        soci::use (ledgerSeq), soci::use (status),
+        soci::use (rawTxn, rti), soci::use (txnMeta, tmi));
+
+    // Ordered so that the numbering below is repeatable
+    soci::statement selectAcctTrans = (session.prepare <<
+        "SELECT TransID, Account, LedgerSeq, TxnSeq "
+        "FROM AccountTransactions WHERE LedgerSeq BETWEEN :lo AND :hi "
+        "ORDER BY LedgerSeq, Account, TransID;",
+        soci::into (transID), soci::into (account),
+        soci::into (ledgerSeq), soci::into (txnSeq),
+        soci::use (lo), soci::use (hi));
+
+    soci::statement insertAcctTrans = (session.prepare <<
+        "INSERT OR REPLACE INTO CompactAccountTransactions "
+        "(Account, LedgerSeq, TxnSeq, TransID) VALUES "
+        "(:account, :ledgerSeq, :txnSeq, :transID);",
+        soci::use (accountBlob), soci::use (ledgerSeq),
+        soci::use (newTxnSeq), soci::use (transIDBlob));
+
+    auto const setTransID = [&]
+    {
+        uint256 id;
+        id.SetHex (transID.value_or (""), true);
+        transIDBlob.trim (0);
+        convert (Blob (id.begin (), id.end ()), transIDBlob);
+    };
+
+    std::size_t renumbered = 0;
+    std::size_t skipped = 0;
+
+    for (; last && lo <= *last; lo = hi + 1)
+    {
+        hi = std::min (lo + ledgersPerBatch - 1, *last);
+
+        soci::transaction tr (session);
+
+        std::size_t transactions = 0;
+        selectTrans.execute ();
+        while (selectTrans.fetch ())
+        {
+            setTransID ();
+            insertTrans.execute (true);
+            ++transactions;
+        }
+
+        // addTxnSeqField stored -1 for transactions it found no
+        // metadata for, and older rows may have no TxnSeq at all.
+        // Those would share one primary key per account and ledger,
+        // so they are numbered downwards from -1 instead.
+        std::map<std::pair<AccountID, std::uint64_t>, std::int64_t> unknown;
+
+        selectAcctTrans.execute ();
+        while (selectAcctTrans.fetch ())
+        {
+            auto const id = parseBase58<AccountID> (account.value_or (""));
+            if (! id || ! ledgerSeq)
+            {
+                JLOG (m_journal.warn()) << "Skipping account transaction " <<
+                    transID.value_or ("") << " with bad account " <<
+                    account.value_or ("") << " or no ledger";
+                ++skipped;
+                continue;
+            }
+
+            if (txnSeq && *txnSeq >= 0)
+            {
+                newTxnSeq = *txnSeq;
+            }
+            else
+            {
+                newTxnSeq = --unknown[std::make_pair (*id, *ledgerSeq)];
+                ++renumbered;
+            }
+
+            setTransID ();
+            accountBlob.trim (0);
+            convert (Blob (id->begin (), id->end ()), accountBlob);
+            insertAcctTrans.execute (true);
+        }
+
+        tr.commit ();
+
+        JLOG (m_journal.info()) << "Converted ledgers " << lo << " to " << hi
+            << " (" << transactions << " transactions) of " << *last;
+    }
+
+    if (renumbered != 0)
+        JLOG (m_journal.warn()) << renumbered << " account transactions had "
+            "no transaction sequence and were numbered below zero";
+    if (skipped != 0)
+        JLOG (m_journal.warn()) << skipped << " account transactions could "
+            "not be converted and were dropped";
+
+    JLOG (m_journal.info()) << "Replacing the transaction tables";
+
+    soci::transaction tr (session);
+    session << "DROP TABLE AccountTransactions;";
+    session << "DROP TABLE Transactions;";
+    session << "DROP TABLE CompactProgress;";
+    session << "ALTER TABLE CompactTransactions RENAME TO Transactions;";
+    session << "ALTER TABLE CompactAccountTransactions "
+        "RENAME TO AccountTransactions;";
+
+    // These should be identical to those in TxnDBInit
+    JLOG (m_journal.info()) << "Building new indexes";
+    session << "CREATE INDEX IF NOT EXISTS TxLgrIndex ON "
+        "Transactions(LedgerSeq);";
+    session << "CREATE INDEX IF NOT EXISTS AcctTxIDIndex ON "
+        "AccountTransactions(TransID);";
+    session << "CREATE INDEX IF NOT EXISTS AcctLgrIndex ON "
+        "AccountTransactions(LedgerSeq);";
+
+    // Part of the same transaction, so the version and the
+    // tables it describes always agree.
+    session << "PRAGMA user_version = " << TxnDBVersion << ";";
+    tr.commit ();
+
+    txnDBVersion_ = TxnDBVersion;
+}
+
 void ApplicationImp::addValidationSeqFields ()
 {
     if (schemaHas(getLedgerDB(), "Validations", 0, "LedgerSeq", m_journal))
@@ -2086,12 +2406,21 @@ bool ApplicationImp::updateTables ()
     assert (!schemaHas (getTxnDB (), "AccountTransactions", 0, "foobar", m_journal));
     addTxnSeqField ();
 
-    if (schemaHas (getTxnDB (), "AccountTransactions", 0, "PRIMARY", m_journal))
+    if (! schemaHas (getTxnDB (), "AccountTransactions", 0, "WITHOUT ROWID", m_journal) &&
+        schemaHas (getTxnDB (), "AccountTransactions", 0, "PRIMARY", m_journal))
     {
         JLOG (m_journal.fatal()) << "AccountTransactions database should not have a primary key";
         return false;
     }
 
+    // The server keeps using text keys until it is told to convert
+    txnDBVersion_ = readTxnDBVersion ();
+    if (config_->doCompactTxnDB)
+        compactTxnTables ();
+    else if (txnDBVersion_ < TxnDBVersion)
+        JLOG (m_journal.warn()) << "The transaction database uses text "
+            "keys; start once with --compact-txdb to convert it";
+
     addValidationSeqFields ();
 
     if (config_->doImport)
@@ -44,6 +44,8 @@ class CachedSLEs;
 class CollectorManager;
 class Family;
 class HashRouter;
+class BatchVerifier;
+class ApplyProfiler;
 class Logs;
 class LoadFeeTrack;
 class JobQueue;
@@ -62,6 +64,7 @@ class PendingSaves;
 class PublicKey;
 class SecretKey;
 class AccountIDCache;
+class AccountHistory;
 class STLedgerEntry;
 class TimeKeeper;
 class TransactionMaster;
@@ -135,6 +138,8 @@ public:
     virtual CachedSLEs&             cachedSLEs() = 0;
     virtual AmendmentTable&         getAmendmentTable() = 0;
     virtual HashRouter&             getHashRouter () = 0;
+    virtual BatchVerifier&          getBatchVerifier () = 0;
+    virtual ApplyProfiler&          getApplyProfiler () = 0;
     virtual LoadFeeTrack&           getFeeTrack () = 0;
     virtual LoadManager&            getLoadManager () = 0;
     virtual Overlay&                overlay () = 0;
@@ -177,7 +182,11 @@ public:
     virtual OpenLedger&             openLedger() = 0;
     virtual OpenLedger const&       openLedger() const = 0;
     virtual DatabaseCon& getTxnDB () = 0;
+    /** The schema version of the transaction database, see TxnDBVersion. */
+    virtual int getTxnDBVersion () const = 0;
     virtual DatabaseCon& getLedgerDB () = 0;
+    /** The account history index, or nullptr if none is configured. */
+    virtual AccountHistory* getAccountHistory () = 0;
     virtual std::chrono::milliseconds getIOLatency () = 0;
 
     virtual bool serverOkay (std::string& reason) = 0;
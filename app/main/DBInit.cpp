@@ -19,11 +19,66 @@
 
 #include <BeastConfig.h>
 #include <ripple/app/main/DBInit.h>
+#include <ripple/basics/strHex.h>
 #include <type_traits>
 
 namespace ripple {
 
 // Transaction database holds transactions and public keys
+//
+// Transaction IDs and accounts are stored as 32 and 20 byte blobs.
+// Databases created with hex and base58 text keys keep them until
+// ApplicationImp::compactTxnTables converts them.
+int const TxnDBVersion = 1;
+
+Blob
+txnDBKey (int version, uint256 const& id)
+{
+    if (version >= TxnDBVersion)
+        return Blob (id.begin (), id.end ());
+    auto const text = to_string (id);
+    return Blob (text.begin (), text.end ());
+}
+
+Blob
+txnDBKey (int version, AccountID const& account,
+    AccountIDCache const& idCache)
+{
+    if (version >= TxnDBVersion)
+        return Blob (account.begin (), account.end ());
+    auto const text = idCache.toBase58 (account);
+    return Blob (text.begin (), text.end ());
+}
+
+std::string
+txnDBLiteral (int version, uint256 const& id)
+{
+    if (version >= TxnDBVersion)
+        return "X'" + strHex (id.begin (), id.size ()) + "'";
+    return "'" + to_string (id) + "'";
+}
+
+std::string
+txnDBLiteral (int version, AccountID const& account,
+    AccountIDCache const& idCache)
+{
+    if (version >= TxnDBVersion)
+        return "X'" + strHex (account.begin (), account.size ()) + "'";
+    return "'" + idCache.toBase58 (account) + "'";
+}
+
+std::string
+txnDBAccountOrder (int version, bool descending)
+{
+    std::string const dir = descending ? " DESC" : " ASC";
+    std::string ret =
+        "AccountTransactions.LedgerSeq" + dir +
+        ", AccountTransactions.TxnSeq" + dir;
+    if (version < TxnDBVersion)
+        ret += ", AccountTransactions.TransID" + dir;
+    return ret;
+}
+
 const char* TxnDBInit[] =
 {
     "PRAGMA synchronous=NORMAL;",
@@ -38,7 +93,7 @@ const char* TxnDBInit[] =
     "BEGIN TRANSACTION;",
 
     "CREATE TABLE IF NOT EXISTS Transactions (                \
-        TransID     CHARACTER(64) PRIMARY KEY,  \
+        TransID     BLOB PRIMARY KEY,           \
         TransType   CHARACTER(24),              \
         FromAcct    CHARACTER(35),              \
         FromSeq     BIGINT UNSIGNED,            \
@@ -59,18 +114,19 @@ const char* TxnDBInit[] =
         Name        CHARACTER(64)              \
     );",
 
+    // Clustered by account, so one account's history is
+    // stored together in the order account_tx reads it.
     "CREATE TABLE IF NOT EXISTS AccountTransactions (         \
-        TransID     CHARACTER(64),              \
-        Account     CHARACTER(64),              \
+        Account     BLOB,                       \
         LedgerSeq   BIGINT UNSIGNED,            \
-        TxnSeq      INTEGER                     \
-    );",
+        TxnSeq      INTEGER,                    \
+        TransID     BLOB,                       \
+        PRIMARY KEY (Account, LedgerSeq, TxnSeq) \
+    ) WITHOUT ROWID;",
     "CREATE INDEX IF NOT EXISTS AcctTxIDIndex ON              \
         AccountTransactions(TransID);",
-    "CREATE INDEX IF NOT EXISTS AcctTxIndex ON                \
-        AccountTransactions(Account, LedgerSeq, TxnSeq, TransID);",
     "CREATE INDEX IF NOT EXISTS AcctLgrIndex ON               \
-        AccountTransactions(LedgerSeq, Account, TransID);",
+        AccountTransactions(LedgerSeq);",
 
     "END TRANSACTION;"
 };
@@ -20,8 +20,43 @@
 #ifndef RIPPLE_APP_DATA_DBINIT_H_INCLUDED
 #define RIPPLE_APP_DATA_DBINIT_H_INCLUDED
 
+#include <ripple/basics/base_uint.h>
+#include <ripple/basics/Blob.h>
+#include <ripple/protocol/AccountID.h>
+#include <string>
+
 namespace ripple {
 
+// The schema version TxnDBInit creates, kept in PRAGMA user_version.
+// Version 0 databases key transactions by hex and accounts by base58
+// text until they are converted with --compact-txdb.
+extern int const TxnDBVersion;
+
+/** The key a transaction database of the given version stores. */
+Blob
+txnDBKey (int version, uint256 const& id);
+
+Blob
+txnDBKey (int version, AccountID const& account,
+    AccountIDCache const& idCache);
+
+/** The same keys as SQL literals. */
+std::string
+txnDBLiteral (int version, uint256 const& id);
+
+std::string
+txnDBLiteral (int version, AccountID const& account,
+    AccountIDCache const& idCache);
+
+/** The ORDER BY terms that page an account's AccountTransactions rows.
+
+    Version 0 tables can hold several rows with the same TxnSeq in one
+    ledger, so the transaction ID breaks those ties; later versions key
+    the rows by (Account, LedgerSeq, TxnSeq) and need no tie breaker.
+*/
+std::string
+txnDBAccountOrder (int version, bool descending);
+
 // VFALCO TODO Tidy these up into a class with functions and return types.
 extern const char* TxnDBInit[];
 extern const char* LedgerDBInit[];
@@ -21,10 +21,12 @@
 #include <ripple/basics/Log.h>
 #include <ripple/protocol/digest.h>
 #include <ripple/app/main/Application.h>
+#include <ripple/app/ledger/LedgerReplayRange.h>
 #include <ripple/basics/CheckLibraryVersions.h>
 #include <ripple/basics/contract.h>
 #include <ripple/basics/StringUtilities.h>
 #include <ripple/basics/Sustain.h>
+#include <ripple/consensus/ConsensusSim.h>
 #include <ripple/core/Config.h>
 #include <ripple/core/ConfigSections.h>
 #include <ripple/core/TerminateHandler.h>
@@ -35,6 +37,7 @@
 #include <ripple/resource/Fees.h>
 #include <ripple/rpc/RPCHandler.h>
 #include <ripple/protocol/BuildInfo.h>
+#include <ripple/protocol/JsonFields.h>
 #include <ripple/beast/clock/basic_seconds_clock.h>
 #include <ripple/beast/core/CurrentThreadName.h>
 #include <ripple/beast/core/Time.h>
@@ -242,6 +245,20 @@ int run (int argc, char** argv)
     ("load", "Load the current ledger from the local DB.")
     ("valid", "Consider the initial ledger a valid network ledger.")
     ("replay","Replay a ledger close.")
+    ("replay-range", po::value<std::vector<std::uint32_t>> ()->multitoken (), "Replay the ledgers START through END, report timings and exit.")
+    ("replay-repeat", po::value<std::size_t> ()->default_value (1), "Number of times to replay the --replay-range.")
+    ("replay-save", "Also save the ledgers of the --replay-range to the databases.")
+    ("sim-consensus", "Run consensus between simulated peers, report and exit.")
+    ("sim-peers", po::value<std::size_t> ()->default_value (5), "Number of peers in the --sim-consensus.")
+    ("sim-ledgers", po::value<std::size_t> ()->default_value (20), "Ledgers every peer closes in the --sim-consensus.")
+    ("sim-txs", po::value<std::size_t> ()->default_value (100), "Transactions per second submitted in the --sim-consensus.")
+    ("sim-latency", po::value<std::uint32_t> ()->default_value (50), "Link latency in milliseconds in the --sim-consensus.")
+    ("sim-jitter", po::value<std::uint32_t> ()->default_value (20), "Most extra milliseconds a message takes in the --sim-consensus.")
+    ("sim-loss", po::value<std::size_t> ()->default_value (0), "Percentage of messages lost in the --sim-consensus.")
+    ("sim-skew", po::value<std::uint32_t> ()->default_value (0), "Most milliseconds a peer's clock is off in the --sim-consensus.")
+    ("sim-apply", po::value<std::uint32_t> ()->default_value (100), "Microseconds to apply a transaction in the --sim-consensus.")
+    ("sim-adaptive", "Adapt the ledger open time to the backlog in the --sim-consensus.")
+    ("sim-seed", po::value<std::uint64_t> ()->default_value (1), "Seed of the random choices of the --sim-consensus.")
     ("ledger", po::value<std::string> (), "Load the specified ledger and start from .")
     ("ledgerfile", po::value<std::string> (), "Load the specified ledger file.")
     ("start", "Start from a fresh Ledger.")
@@ -249,6 +266,7 @@ int run (int argc, char** argv)
     ("debug", "Enable normally suppressed debug logging")
     ("fg", "Run in the foreground.")
     ("import", importText.c_str ())
+    ("compact-txdb", "Convert the transaction database to binary keys before starting.")
     ("version", "Display the build version.")
     ;
 
@@ -301,14 +319,64 @@ int run (int argc, char** argv)
             bool (vm.count ("unittest-log")));
     }
 
+    // Simulate consensus if requested.
+    // The simulation needs no configuration and exits when it is done.
+    //
+    if (vm.count ("sim-consensus"))
+    {
+        using namespace std::chrono;
+        ConsensusSimSetup setup;
+        setup.peers = vm["sim-peers"].as<std::size_t> ();
+        setup.ledgers = vm["sim-ledgers"].as<std::size_t> ();
+        setup.txRate = vm["sim-txs"].as<std::size_t> ();
+        setup.latency = milliseconds (vm["sim-latency"].as<std::uint32_t> ());
+        setup.jitter = milliseconds (vm["sim-jitter"].as<std::uint32_t> ());
+        setup.lossPct = vm["sim-loss"].as<std::size_t> ();
+        setup.skew = milliseconds (vm["sim-skew"].as<std::uint32_t> ());
+        setup.applyCost = microseconds (vm["sim-apply"].as<std::uint32_t> ());
+        setup.seed = vm["sim-seed"].as<std::uint64_t> ();
+        if (setup.peers == 0 || setup.lossPct >= 100)
+        {
+            std::cerr << "Invalid --sim-peers or --sim-loss" << std::endl;
+            return -1;
+        }
+
+        ConsensusParms parms;
+        parms.ledgerADAPTIVE_CLOSE = bool (vm.count ("sim-adaptive"));
+
+        Logs logs (vm.count ("verbose") ? beast::severities::kTrace :
+            beast::severities::kWarning);
+        auto const report = simulateConsensus (
+            setup, parms, logs.journal ("ConsensusSim"));
+        std::cout << Json::pretty (report) << std::endl;
+        return report[jss::status] == "success" ? 0 : -1;
+    }
+
     auto config = std::make_unique<Config>();
 
     auto configFile = vm.count ("conf") ?
             vm["conf"].as<std::string> () : std::string();
 
+    std::uint32_t replayFirst = 0;
+    std::uint32_t replayLast = 0;
+    if (vm.count ("replay-range"))
+    {
+        auto const& range = vm["replay-range"].as<std::vector<std::uint32_t>> ();
+        if (range.size () != 2 || range[0] == 0 || range[0] > range[1] ||
+            vm["replay-repeat"].as<std::size_t> () == 0)
+        {
+            std::cerr << "Invalid --replay-range, expected START END" << std::endl;
+            return -1;
+        }
+        replayFirst = range[0];
+        replayLast = range[1];
+    }
+
     // config file, quiet flag.
+    // A range replay never talks to the network.
     config->setup (configFile, bool (vm.count ("quiet")),
-        bool(vm.count("silent")), bool(vm.count("standalone")));
+        bool(vm.count("silent")),
+        bool(vm.count("standalone")) || replayFirst != 0);
 
     {
         // Stir any previously saved entropy into the pool:
@@ -323,6 +391,9 @@ int run (int argc, char** argv)
     if (vm.count ("import"))
         config->doImport = true;
 
+    if (vm.count ("compact-txdb"))
+        config->doCompactTxnDB = true;
+
     if (vm.count ("ledger"))
     {
         config->START_LEDGER = vm["ledger"].as<std::string> ();
@@ -341,6 +412,13 @@ int run (int argc, char** argv)
         config->START_UP = Config::LOAD;
     }
 
+    if (replayFirst != 0)
+    {
+        // Start from the parent of the first ledger replayed
+        config->START_LEDGER = std::to_string (replayFirst - 1);
+        config->START_UP = Config::LOAD;
+    }
+
     if (vm.count ("valid"))
     {
         config->START_VALID = true;
@@ -480,6 +558,21 @@ int run (int argc, char** argv)
             return -1;
         }
 
+        if (replayFirst != 0)
+        {
+            app->doStart(false /*start timers*/);
+
+            auto const report = replayLedgerRange (*app,
+                replayFirst, replayLast,
+                vm["replay-repeat"].as<std::size_t> (),
+                bool (vm.count ("replay-save")));
+            std::cout << Json::pretty (report) << std::endl;
+
+            app->signalStop();
+            app->run();
+            return report[jss::status] == "success" ? 0 : -1;
+        }
+
         // Start the server
         app->doStart(true /*start timers*/);
 
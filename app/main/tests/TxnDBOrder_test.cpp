@@ -0,0 +1,150 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/main/DBInit.h>
+#include <ripple/basics/base_uint.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/core/SociDB.h>
+#include <boost/format.hpp>
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+class TxnDBOrder_test : public beast::unit_test::suite
+{
+    struct Row
+    {
+        std::uint32_t ledger;
+        std::string id;
+    };
+
+    // Read one account's transaction IDs a page at a time, the way
+    // account_tx does with its offset and limit.
+    std::vector<std::string>
+    readPaged (soci::session& s, bool descending, std::size_t pageSize)
+    {
+        std::vector<std::string> ret;
+        for (std::size_t offset = 0;; offset += pageSize)
+        {
+            auto const sql = boost::str (boost::format (
+                "SELECT TransID FROM AccountTransactions "
+                "WHERE Account = 'rAccount' ORDER BY %s LIMIT %u, %u;")
+                % txnDBAccountOrder (0, descending)
+                % offset
+                % pageSize);
+
+            std::size_t const before = ret.size ();
+            soci::rowset<std::string> rs = (s.prepare << sql);
+            for (auto const& id : rs)
+                ret.push_back (id);
+            if (ret.size () - before < pageSize)
+                return ret;
+        }
+    }
+
+public:
+    void
+    testDuplicateTxnSeq ()
+    {
+        testcase ("Paging version 0 rows with duplicate TxnSeq");
+
+        soci::session s;
+        open (s, "sqlite", ":memory:");
+        s << "CREATE TABLE AccountTransactions ("
+             "TransID CHARACTER(64), Account CHARACTER(64), "
+             "LedgerSeq BIGINT UNSIGNED, TxnSeq INTEGER);";
+        // No index covers the whole order, so SQLite sorts the rows
+        // and leaves rows with equal keys in the order it found them.
+        s << "CREATE INDEX AcctTxIDIndex ON "
+             "AccountTransactions(TransID);";
+
+        // Rows are inserted out of ID order, so nothing but the tie
+        // breaker puts rows with the same TxnSeq in ID order. Ledger 10
+        // has the -1 and ledger 11 the NULL TxnSeq that version 0
+        // databases hold for transactions of unknown position.
+        std::vector<Row> rows;
+        for (std::uint32_t ledger : {9, 10, 11})
+        {
+            for (std::uint64_t n : {5, 2, 7, 1, 4, 6, 3})
+            {
+                rows.push_back ({ledger,
+                    to_string (uint256 (ledger * 100 + n))});
+
+                std::string txnSeq = "NULL";
+                if (ledger == 9)
+                    txnSeq = std::to_string (n);
+                else if (ledger == 10)
+                    txnSeq = "-1";
+
+                s << boost::str (boost::format (
+                    "INSERT INTO AccountTransactions VALUES "
+                    "('%s', 'rAccount', %u, %s);")
+                    % rows.back ().id % ledger % txnSeq);
+            }
+        }
+
+        std::vector<std::string> expected;
+        std::sort (rows.begin (), rows.end (),
+            [](Row const& a, Row const& b)
+            {
+                return std::tie (a.ledger, a.id) < std::tie (b.ledger, b.id);
+            });
+        for (auto const& row : rows)
+            expected.push_back (row.id);
+
+        for (std::size_t pageSize : {1, 2, 3, 5, 100})
+        {
+            BEAST_EXPECT (readPaged (s, false, pageSize) == expected);
+            BEAST_EXPECT (readPaged (s, true, pageSize) ==
+                std::vector<std::string> (
+                    expected.rbegin (), expected.rend ()));
+        }
+    }
+
+    void
+    testOrder ()
+    {
+        testcase ("Order by version");
+
+        BEAST_EXPECT (txnDBAccountOrder (0, false) ==
+            "AccountTransactions.LedgerSeq ASC, "
+            "AccountTransactions.TxnSeq ASC, "
+            "AccountTransactions.TransID ASC");
+        BEAST_EXPECT (txnDBAccountOrder (TxnDBVersion, true) ==
+            "AccountTransactions.LedgerSeq DESC, "
+            "AccountTransactions.TxnSeq DESC");
+    }
+
+    void
+    run () override
+    {
+        testDuplicateTxnSeq ();
+        testOrder ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE (TxnDBOrder, app, ripple);
+
+} // test
+} // ripple
@@ -0,0 +1,123 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_APP_MISC_ACCOUNTHISTORY_H_INCLUDED
+#define RIPPLE_APP_MISC_ACCOUNTHISTORY_H_INCLUDED
+
+#include <ripple/basics/BasicConfig.h>
+#include <ripple/basics/Blob.h>
+#include <ripple/beast/utility/Journal.h>
+#include <ripple/json/json_value.h>
+#include <ripple/protocol/Protocol.h>
+#include <ripple/protocol/AccountID.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ripple {
+
+/** An index of each account's transactions kept outside SQL.
+
+    Entries are kept in an ordered key-value store, keyed by
+    (account, ledger sequence, transaction sequence), so a page of
+    one account's history is a single range scan in either
+    direction. Each transaction's raw form and metadata are stored
+    once, keyed by (ledger sequence, transaction sequence), along
+    with the accounts it affected.
+
+    It is written when a validated ledger is saved and answers the
+    same paged queries as accountTxPage, with the same markers.
+
+    Ledgers can be saved out of order, saves can fail, and the index
+    may be enabled on a server that already has history, so it keeps
+    track of the one contiguous range of ledgers it holds completely.
+    Queries reaching outside that range must be answered from SQL.
+
+    Thread safety:
+        All members may be called concurrently.
+*/
+class AccountHistory
+{
+public:
+    /** One transaction in a saved ledger. */
+    struct Entry
+    {
+        std::uint32_t txnSeq;
+        Blob rawTxn;
+        Blob rawMeta;
+        std::vector<AccountID> accounts;
+    };
+
+    using OnTransaction = std::function<void (std::uint32_t,
+        std::string const&, Blob const&, Blob const&)>;
+
+    virtual ~AccountHistory () = default;
+
+    /** Replace everything stored for one ledger.
+
+        A ledger adjoining the covered range extends it. A ledger far
+        past its end, after the ones between never arrived, starts a
+        new range. A failed write takes the ledger out of the range.
+    */
+    virtual
+    void
+    saveLedger (LedgerIndex seq, std::vector<Entry> const& entries) = 0;
+
+    /** Remove every ledger before `seq`, covered or not. */
+    virtual
+    void
+    deleteBefore (LedgerIndex seq) = 0;
+
+    /** Whether every ledger from `minLedger` to `maxLedger` is held. */
+    virtual
+    bool
+    covers (LedgerIndex minLedger, LedgerIndex maxLedger) const = 0;
+
+    /** Visit one page of an account's transactions.
+
+        The arguments and the marker left in `token` are the same as
+        for accountTxPage.
+    */
+    virtual
+    void
+    page (
+        OnTransaction const& onTransaction,
+        AccountID const& account,
+        std::int32_t minLedger,
+        std::int32_t maxLedger,
+        bool forward,
+        Json::Value& token,
+        int limit,
+        bool bAdmin,
+        std::uint32_t pageLength) = 0;
+};
+
+/** Open the index described by an [account_history_db] section.
+
+    Returns nullptr if the section is empty.
+*/
+std::unique_ptr<AccountHistory>
+make_AccountHistory (Section const& section, beast::Journal journal);
+
+} // ripple
+
+#endif
@@ -0,0 +1,95 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_MISC_BATCHVERIFIER_H_INCLUDED
+#define RIPPLE_APP_MISC_BATCHVERIFIER_H_INCLUDED
+
+#include <ripple/protocol/STTx.h>
+#include <ripple/beast/utility/Journal.h>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace ripple {
+
+class Application;
+
+/** Verifies the signatures of inbound transactions in batches.
+
+    Only single signed Ed25519 transactions are queued here, since
+    that is the only key type with a batch check. Jobs on the job
+    queue drain the queue, splitting what is waiting between them,
+    so whatever arrives while a job is waiting to run is checked
+    together. Anything else goes straight to its own job and is
+    checked there.
+
+    Results are recorded in the HashRouter, as checkValidity does,
+    before the handler for each transaction is posted as a job of
+    its own. The handler then finds the signature state cached.
+
+    @see checkSignatures
+*/
+class BatchVerifier
+{
+public:
+    using Handler = std::function<void()>;
+
+    BatchVerifier (Application& app, beast::Journal j);
+
+    BatchVerifier (BatchVerifier const&) = delete;
+    BatchVerifier& operator= (BatchVerifier const&) = delete;
+
+    /** Queue a transaction for signature verification.
+
+        @param handler Called from its own job, once the result
+                       is recorded in the HashRouter if the
+                       transaction was batched.
+    */
+    void
+    add (std::shared_ptr<STTx const> const& stx, Handler handler);
+
+    /** Number of transactions waiting to be picked up by a job. */
+    std::size_t
+    size() const;
+
+private:
+    // Job body, verifies batches until the queue is empty
+    void
+    run();
+
+    // Post a handler as a transaction job
+    void
+    post (Handler handler);
+
+    Application& app_;
+    beast::Journal j_;
+
+    mutable std::mutex mutex_;
+    std::vector<std::pair<std::shared_ptr<STTx const>, Handler>> pending_;
+
+    // Jobs queued or running
+    std::size_t jobs_ = 0;
+};
+
+} // ripple
+
+#endif
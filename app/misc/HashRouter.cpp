@@ -23,48 +23,85 @@
 namespace ripple {
 
 auto
-HashRouter::emplace (uint256 const& key)
+HashRouter::emplace (Shard& shard, uint256 const& key,
+    Stopwatch::time_point now)
     -> std::pair<Entry&, bool>
 {
-    auto iter = suppressionMap_.find (key);
+    std::uint64_t const bucket =
+        now.time_since_epoch () / bucketWidth_;
 
-    if (iter != suppressionMap_.end ())
+    auto iter = shard.entries.find (key);
+    bool const inserted = iter == shard.entries.end ();
+
+    if (inserted)
     {
-        suppressionMap_.touch(iter);
-        return std::make_pair(
-            std::ref(iter->second), false);
+        // See if any supressions need to be expired
+        expire (shard, now);
+
+        iter = shard.entries.emplace (key, Entry ()).first;
     }
 
-    // See if any supressions need to be expired
-    expire(suppressionMap_, holdTime_);
+    if (iter->second.touch (now, bucket))
+    {
+        if (shard.buckets.empty () || shard.buckets.back ().first != bucket)
+            shard.buckets.emplace_back (bucket, std::vector<uint256> ());
+        shard.buckets.back ().second.push_back (key);
+    }
 
-    return std::make_pair(std::ref(
-        suppressionMap_.emplace (
-            key, Entry ()).first->second),
-                true);
+    return std::make_pair(std::ref(iter->second), inserted);
+}
+
+void
+HashRouter::expire (Shard& shard, Stopwatch::time_point now)
+{
+    std::uint64_t const current =
+        now.time_since_epoch () / bucketWidth_;
+    std::uint64_t const span =
+        std::chrono::duration_cast<Stopwatch::duration> (holdTime_) /
+            bucketWidth_;
+
+    // Only whole buckets older than the hold time are examined, so an
+    // insert costs nothing until a bucket falls out of the window.
+    while (! shard.buckets.empty () &&
+        shard.buckets.front ().first + span < current)
+    {
+        for (auto const& key : shard.buckets.front ().second)
+        {
+            auto iter = shard.entries.find (key);
+            if (iter != shard.entries.end () &&
+                iter->second.touched () + holdTime_ <= now)
+            {
+                shard.entries.erase (iter);
+            }
+        }
+        shard.buckets.pop_front ();
+    }
 }
 
 void HashRouter::addSuppression (uint256 const& key)
 {
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto& shard = this->shard (key);
+    std::lock_guard <std::mutex> lock (shard.mutex);
 
-    emplace (key);
+    emplace (shard, key, clock_.now ());
 }
 
 bool HashRouter::addSuppressionPeer (uint256 const& key, PeerShortID peer)
 {
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto& shard = this->shard (key);
+    std::lock_guard <std::mutex> lock (shard.mutex);
 
-    auto result = emplace(key);
+    auto result = emplace(shard, key, clock_.now ());
     result.first.addPeer(peer);
     return result.second;
 }
 
 bool HashRouter::addSuppressionPeer (uint256 const& key, PeerShortID peer, int& flags)
 {
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto& shard = this->shard (key);
+    std::lock_guard <std::mutex> lock (shard.mutex);
 
-    auto result = emplace(key);
+    auto result = emplace(shard, key, clock_.now ());
     auto& s = result.first;
     s.addPeer (peer);
     flags = s.getFlags ();
@@ -74,9 +111,10 @@ bool HashRouter::addSuppressionPeer (uint256 const& key, PeerShortID peer, int&
 bool HashRouter::shouldProcess (uint256 const& key, PeerShortID peer, int& flags,
     Stopwatch::time_point now, std::chrono::seconds interval)
 {
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto& shard = this->shard (key);
+    std::lock_guard <std::mutex> lock (shard.mutex);
 
-    auto result = emplace(key);
+    auto result = emplace(shard, key, clock_.now ());
     auto& s = result.first;
     s.addPeer (peer);
     flags = s.getFlags ();
@@ -85,18 +123,20 @@ bool HashRouter::shouldProcess (uint256 const& key, PeerShortID peer, int& flags
 
 int HashRouter::getFlags (uint256 const& key)
 {
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto& shard = this->shard (key);
+    std::lock_guard <std::mutex> lock (shard.mutex);
 
-    return emplace(key).first.getFlags ();
+    return emplace(shard, key, clock_.now ()).first.getFlags ();
 }
 
 bool HashRouter::setFlags (uint256 const& key, int flags)
 {
     assert (flags != 0);
 
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto& shard = this->shard (key);
+    std::lock_guard <std::mutex> lock (shard.mutex);
 
-    auto& s = emplace(key).first;
+    auto& s = emplace(shard, key, clock_.now ()).first;
 
     if ((s.getFlags () & flags) == flags)
         return false;
@@ -107,13 +147,15 @@ bool HashRouter::setFlags (uint256 const& key, int flags)
 
 auto
 HashRouter::shouldRelay (uint256 const& key)
-    -> boost::optional<std::set<PeerShortID>>
+    -> boost::optional<PeerShortIDSet>
 {
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto& shard = this->shard (key);
+    std::lock_guard <std::mutex> lock (shard.mutex);
 
-    auto& s = emplace(key).first;
+    auto const now = clock_.now ();
+    auto& s = emplace(shard, key, now).first;
 
-    if (!s.shouldRelay(suppressionMap_.clock().now(), holdTime_))
+    if (!s.shouldRelay(now, holdTime_))
         return boost::none;
 
     return s.releasePeerSet();
@@ -122,9 +164,10 @@ HashRouter::shouldRelay (uint256 const& key)
 bool
 HashRouter::shouldRecover(uint256 const& key)
 {
-    std::lock_guard <std::mutex> lock(mutex_);
+    auto& shard = this->shard (key);
+    std::lock_guard <std::mutex> lock(shard.mutex);
 
-    auto& s = emplace(key).first;
+    auto& s = emplace(shard, key, clock_.now ()).first;
 
     return s.shouldRecover(recoverLimit_);
 }
@@ -24,8 +24,14 @@
 #include <ripple/basics/chrono.h>
 #include <ripple/basics/CountedObject.h>
 #include <ripple/basics/UnorderedContainers.h>
-#include <ripple/beast/container/aged_unordered_map.h>
+#include <boost/container/flat_set.hpp>
 #include <boost/optional.hpp>
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <vector>
 
 namespace ripple {
 
@@ -49,6 +55,10 @@ namespace ripple {
     This table keeps track of which hashes have been received by which peers.
     It is used to manage the routing and broadcasting of messages in the peer
     to peer overlay.
+
+    The table is split into shards, each with its own lock, so that peers
+    relaying unrelated messages do not contend. Entries are expired in
+    coarse time buckets rather than by scanning an aged container.
 */
 class HashRouter
 {
@@ -56,6 +66,12 @@ public:
     // The type here *MUST* match the type of Peer::id_t
     using PeerShortID = std::uint32_t;
 
+    /** Peers an item was received from.
+
+        A sorted vector: one allocation per entry, no per-peer nodes.
+    */
+    using PeerShortIDSet = boost::container::flat_set<PeerShortID>;
+
 private:
     /** An entry in the routing table.
     */
@@ -85,9 +101,30 @@ private:
         }
 
         /** Return set of peers we've relayed to and reset tracking */
-        std::set<PeerShortID> releasePeerSet()
+        PeerShortIDSet releasePeerSet()
+        {
+            PeerShortIDSet result;
+            result.swap (peers_);
+            return result;
+        }
+
+        /** Record a use of the entry.
+
+            @return `true` if the entry is not yet listed in the
+                expiration bucket `bucket`.
+        */
+        bool touch (Stopwatch::time_point now, std::uint64_t bucket)
+        {
+            touched_ = now;
+            if (bucket_ == bucket)
+                return false;
+            bucket_ = bucket;
+            return true;
+        }
+
+        Stopwatch::time_point touched () const
         {
-            return std::move(peers_);
+            return touched_;
         }
 
         /** Determines if this item should be relayed.
@@ -128,7 +165,9 @@ private:
 
     private:
         int flags_ = 0;
-        std::set <PeerShortID> peers_;
+        PeerShortIDSet peers_;
+        Stopwatch::time_point touched_;
+        std::uint64_t bucket_ = std::numeric_limits<std::uint64_t>::max ();
         // This could be generalized to a map, if more
         // than one flag needs to expire independently.
         boost::optional<Stopwatch::time_point> relayed_;
@@ -151,8 +190,10 @@ public:
 
     HashRouter (Stopwatch& clock, std::chrono::seconds entryHoldTimeInSeconds,
         std::uint32_t recoverLimit)
-        : suppressionMap_(clock)
+        : clock_ (clock)
         , holdTime_ (entryHoldTimeInSeconds)
+        , bucketWidth_ (std::max<Stopwatch::duration> (
+            holdTime_ / bucketsPerHoldTime, std::chrono::seconds (1)))
         , recoverLimit_ (recoverLimit + 1u)
     {
     }
@@ -194,7 +235,7 @@ public:
             relayed to. If the result is uninitialized, the item should
             _not_ be relayed.
     */
-    boost::optional<std::set<PeerShortID>> shouldRelay(uint256 const& key);
+    boost::optional<PeerShortIDSet> shouldRelay(uint256 const& key);
 
     /** Determines whether the hashed item should be recovered
 
@@ -203,17 +244,44 @@ public:
     bool shouldRecover(uint256 const& key);
 
 private:
+    static std::size_t constexpr shardCount = 16;
+
+    // Expiration granularity: an entry lives between holdTime_ and
+    // holdTime_ plus one bucket width after its last use.
+    static int constexpr bucketsPerHoldTime = 10;
+
+    struct Shard
+    {
+        std::mutex mutex;
+
+        hardened_hash_map<uint256, Entry> entries;
+
+        // Keys touched during each time bucket, oldest first. A key
+        // may appear in several buckets; only the bucket holding its
+        // last use lets it expire.
+        std::deque<std::pair<std::uint64_t, std::vector<uint256>>> buckets;
+    };
+
+    Shard& shard (uint256 const& key)
+    {
+        // Keys are hashes, so any byte is uniformly distributed.
+        return shards_[*key.begin () % shardCount];
+    }
+
     // pair.second indicates whether the entry was created
-    std::pair<Entry&, bool> emplace (uint256 const&);
+    std::pair<Entry&, bool> emplace (Shard&, uint256 const&,
+        Stopwatch::time_point now);
+
+    void expire (Shard&, Stopwatch::time_point now);
 
-    std::mutex mutable mutex_;
+    Stopwatch& clock_;
 
-    // Stores all suppressed hashes and their expiration time
-    beast::aged_unordered_map<uint256, Entry, Stopwatch::clock_type,
-        hardened_hash<strong_hash>> suppressionMap_;
+    std::array<Shard, shardCount> shards_;
 
     std::chrono::seconds const holdTime_;
 
+    Stopwatch::duration const bucketWidth_;
+
     std::uint32_t const recoverLimit_;
 };
 
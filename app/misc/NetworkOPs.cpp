@@ -22,6 +22,7 @@
 #include <ripple/protocol/Quality.h>
 #include <ripple/core/DatabaseCon.h>
 #include <ripple/app/main/Application.h>
+#include <ripple/app/main/DBInit.h>
 #include <ripple/app/ledger/AcceptedLedger.h>
 #include <ripple/app/ledger/InboundLedger.h>
 #include <ripple/app/ledger/InboundLedgers.h>
@@ -36,6 +37,7 @@
 #include <ripple/app/ledger/OrderBookDB.h>
 #include <ripple/app/ledger/TransactionMaster.h>
 #include <ripple/app/main/LoadManager.h>
+#include <ripple/app/misc/AccountHistory.h>
 #include <ripple/app/misc/HashRouter.h>
 #include <ripple/app/misc/LoadFeeTrack.h>
 #include <ripple/app/misc/Transaction.h>
@@ -43,6 +45,7 @@
 #include <ripple/app/misc/ValidatorList.h>
 #include <ripple/app/misc/impl/AccountTxPaging.h>
 #include <ripple/app/tx/apply.h>
+#include <ripple/app/tx/applySteps.h>
 #include <ripple/basics/contract.h>
 #include <ripple/basics/Log.h>
 #include <ripple/basics/mulDiv.h>
@@ -70,6 +73,7 @@
 #include <peersafe/rpc/TableUtils.h>
 #include <beast/core/detail/base64.hpp>
 #include <boost/asio/steady_timer.hpp>
+#include <algorithm>
 
 namespace ripple {
 
@@ -169,6 +173,48 @@ class NetworkOPsImp final
         Json::Value json() const;
     };
 
+    /**
+     * Time spent in each stage of applying transaction batches.
+     */
+    class ApplyAccounting
+    {
+    public:
+        enum Stage
+        {
+            preflight,  // Checks without a ledger, no locks held
+            lockWait,   // Waiting for the master and ledger locks
+            apply,      // Applying to the open ledger under the locks
+            finish,     // Status updates, queueing and relaying
+            stageCount
+        };
+
+        using Durations =
+            std::array<std::chrono::microseconds, stageCount>;
+
+        /**
+         * Record a batch.
+         *
+         * @param transactions Number of transactions in the batch.
+         * @param durations Time spent in each stage.
+         */
+        void record (std::size_t transactions, Durations const& durations);
+
+        /**
+         * Output stage counters in JSON format.
+         *
+         * @return JSON object.
+         */
+        Json::Value json() const;
+
+    private:
+        mutable std::mutex mutex_;
+        std::uint64_t batches_ = 0;
+        std::uint64_t transactions_ = 0;
+        Durations durations_ {};
+        static std::array<Json::StaticString const, stageCount> const
+            stages_;
+    };
+
     //! Server fees published on `server` subscription
     struct ServerFeeSummary
     {
@@ -258,6 +304,19 @@ public:
         std::shared_ptr<Transaction>& transaction,
         bool bUnlimited, bool bLocal, FailHard failType) override;
 
+    void processTransactionSet (
+        std::vector<std::shared_ptr<Transaction>>& transactions,
+        bool bUnlimited, FailHard failType) override;
+
+    /**
+     * Check a transaction before it is applied, and replace it with the
+     * canonical instance.
+     *
+     * @param transaction Transaction object.
+     * @return false if the transaction was rejected.
+     */
+    bool preProcessTransaction (std::shared_ptr<Transaction>& transaction);
+
     /**
      * For transactions submitted directly by a client, apply batch of
      * transactions and wait for this transaction to complete.
@@ -269,6 +328,18 @@ public:
     void doTransactionSync (std::shared_ptr<Transaction> transaction,
         bool bUnlimited, FailHard failType);
 
+    /**
+     * Apply a set of transactions submitted together by a client, as one
+     * batch, and wait for all of them to complete.
+     *
+     * @param transactions Transaction objects.
+     * @param bUnlimited Whether a privileged client connection submitted it.
+     * @param failType fail_hard setting from transaction submission.
+     */
+    void doTransactionSyncSet (
+        std::vector<std::shared_ptr<Transaction>> const& transactions,
+        bool bUnlimited, FailHard failType);
+
     /**
      * For transactions not submitted by a locally connected client, fire and
      * forget. Add to batch and trigger it to be processed if there's no batch
@@ -320,6 +391,15 @@ public:
     bool recvValidation (
         STValidation::ref val, std::string const& source) override;
 
+    void processTrustedProposals (
+        std::vector<std::pair<RCLCxPeerPos,
+            std::shared_ptr<protocol::TMProposeSet>>> const& proposals)
+        override;
+
+    std::vector<bool> recvValidations (
+        std::vector<std::pair<STValidation::pointer,
+            std::string>> const& vals) override;
+
     std::shared_ptr<SHAMap> getTXMap (uint256 const& hash);
     bool hasTXSet (
         const std::shared_ptr<Peer>& peer, uint256 const& set,
@@ -402,6 +482,9 @@ public:
         bool descending, std::uint32_t offset, int limit,
         bool binary, bool count, bool bUnlimited);
 
+    // Whether the account history index holds every ledger in the range
+    bool useAccountHistory (std::int32_t minLedger, std::int32_t maxLedger);
+
     // Client information retrieval functions.
     using NetworkOPs::AccountTxs;
     AccountTxs getAccountTxs (
@@ -664,6 +747,7 @@ private:
     std::vector <TransactionStatus> mTransactions;
 
     StateAccounting accounting_ {};
+    ApplyAccounting applyAccounting_ {};
 
 private:
     SubInfoMapType& getCompatibleSubInfoMap(InfoSub::ACOUNT_TYPE eType);
@@ -696,6 +780,13 @@ NetworkOPsImp::StateAccounting::states_ = {{
     Json::StaticString(stateNames[3]),
     Json::StaticString(stateNames[4])}};
 
+std::array<Json::StaticString const, 4> const
+NetworkOPsImp::ApplyAccounting::stages_ = {{
+    Json::StaticString("preflight"),
+    Json::StaticString("lock_wait"),
+    Json::StaticString("apply"),
+    Json::StaticString("finish")}};
+
 //------------------------------------------------------------------------------
 std::string
 NetworkOPsImp::getHostId (bool forAdmin)
@@ -1005,10 +1096,9 @@ void NetworkOPsImp::submitTransaction (std::shared_ptr<STTx const> const& iTrans
         });
 }
 
-void NetworkOPsImp::processTransaction (std::shared_ptr<Transaction>& transaction,
-        bool bUnlimited, bool bLocal, FailHard failType)
+bool NetworkOPsImp::preProcessTransaction (
+    std::shared_ptr<Transaction>& transaction)
 {
-    auto ev = m_job_queue.makeLoadEvent (jtTXN_PROC, "ProcessTXN");
     auto const newFlags = app_.getHashRouter ().getFlags (transaction->getID ());
 
     if ((newFlags & SF_BAD) != 0)
@@ -1016,7 +1106,7 @@ void NetworkOPsImp::processTransaction (std::shared_ptr<Transaction>& transactio
         // cached bad
         transaction->setStatus (INVALID);
         transaction->setResult (temBAD_SIGNATURE);
-        return;
+        return false;
     }
 
     // NOTE eahennis - I think this check is redundant,
@@ -1038,11 +1128,21 @@ void NetworkOPsImp::processTransaction (std::shared_ptr<Transaction>& transactio
         transaction->setResult(temBAD_SIGNATURE);
         app_.getHashRouter().setFlags(transaction->getID(),
             SF_BAD);
-        return;
+        return false;
     }
 
     // canonicalize can change our pointer
     app_.getMasterTransaction ().canonicalize (&transaction);
+    return true;
+}
+
+void NetworkOPsImp::processTransaction (std::shared_ptr<Transaction>& transaction,
+        bool bUnlimited, bool bLocal, FailHard failType)
+{
+    auto ev = m_job_queue.makeLoadEvent (jtTXN_PROC, "ProcessTXN");
+
+    if (! preProcessTransaction (transaction))
+        return;
 
     if (bLocal)
         doTransactionSync (transaction, bUnlimited, failType);
@@ -1050,6 +1150,24 @@ void NetworkOPsImp::processTransaction (std::shared_ptr<Transaction>& transactio
         doTransactionAsync (transaction, bUnlimited, failType);
 }
 
+void NetworkOPsImp::processTransactionSet (
+    std::vector<std::shared_ptr<Transaction>>& transactions,
+        bool bUnlimited, FailHard failType)
+{
+    auto ev = m_job_queue.makeLoadEvent (jtTXN_PROC, "ProcessTXNSet");
+
+    std::vector<std::shared_ptr<Transaction>> submit;
+    submit.reserve (transactions.size());
+    for (auto& transaction : transactions)
+    {
+        if (preProcessTransaction (transaction))
+            submit.push_back (transaction);
+    }
+
+    if (! submit.empty())
+        doTransactionSyncSet (submit, bUnlimited, failType);
+}
+
 void NetworkOPsImp::doTransactionAsync (std::shared_ptr<Transaction> transaction,
         bool bUnlimited, FailHard failType)
 {
@@ -1076,26 +1194,52 @@ void NetworkOPsImp::doTransactionAsync (std::shared_ptr<Transaction> transaction
 void NetworkOPsImp::doTransactionSync (std::shared_ptr<Transaction> transaction,
         bool bUnlimited, FailHard failType)
 {
-    auto stTx = *transaction->getSTransaction();
-    if (stTx.isAjmChainTableType())
+    doTransactionSyncSet ({std::move (transaction)}, bUnlimited, failType);
+}
+
+void NetworkOPsImp::doTransactionSyncSet (
+    std::vector<std::shared_ptr<Transaction>> const& transactions,
+        bool bUnlimited, FailHard failType)
+{
+    std::vector<std::shared_ptr<Transaction>> submit;
+    submit.reserve (transactions.size());
+    for (auto const& transaction : transactions)
     {
-        bool ret = app_.getTableAssistant().Put(stTx);
-        if (!ret)
+        auto const& stTx = *transaction->getSTransaction();
+        if (stTx.isAjmChainTableType() &&
+            ! app_.getTableAssistant().Put(stTx))
         {
             transaction->setStatus(INVALID);
             transaction->setResult(temBAD_PUT);
-            return;
+            continue;
         }
-	}
+        submit.push_back (transaction);
+    }
+
+    if (submit.empty())
+        return;
+
     std::unique_lock<std::mutex> lock(mMutex);
 
-    if (!transaction->getApplying())
+    for (auto const& transaction : submit)
     {
-        mTransactions.push_back(TransactionStatus(transaction, bUnlimited,
-            true, failType));
-        transaction->setApplying();
+        if (!transaction->getApplying())
+        {
+            mTransactions.push_back(TransactionStatus(transaction, bUnlimited,
+                true, failType));
+            transaction->setApplying();
+        }
     }
 
+    auto const pending = [&submit]
+    {
+        return std::any_of (submit.begin(), submit.end(),
+            [](std::shared_ptr<Transaction> const& t)
+            {
+                return t->getApplying();
+            });
+    };
+
     do
     {
         if (mDispatchState == DispatchState::running)
@@ -1119,7 +1263,7 @@ void NetworkOPsImp::doTransactionSync (std::shared_ptr<Transaction> transaction,
             }
         }
     }
-    while (transaction->getApplying());
+    while (pending());
 }
 
 void NetworkOPsImp::transactionBatch()
@@ -1147,31 +1291,75 @@ void NetworkOPsImp::apply (std::unique_lock<std::mutex>& batchLock)
 
     batchLock.unlock();
 
+    using clock_type = std::chrono::steady_clock;
+    ApplyAccounting::Durations durations {};
+    auto stageStart = clock_type::now();
+    auto const endStage = [&](ApplyAccounting::Stage stage)
+    {
+        auto const now = clock_type::now();
+        durations[stage] = std::chrono::duration_cast<
+            std::chrono::microseconds>(now - stageStart);
+        stageStart = now;
+    };
+
+    auto const applyFlags = [](TransactionStatus const& e)
+    {
+        // we check before addingto the batch
+        ApplyFlags flags = tapNO_CHECK_SIGN;
+        if (e.local)
+            flags = flags | tapFromClient;
+        else
+            flags = flags | tapByRelay;
+
+        if (e.admin)
+            flags = flags | tapUNLIMITED;
+        return flags;
+    };
+
+    // Preflight needs no ledger, so run it for the whole batch before
+    // taking the locks. Transactors with effects outside the ledger
+    // still do all their checks under the locks.
+    std::vector<std::pair<std::shared_ptr<STTx const>, ApplyFlags>> early;
+    std::vector<int> earlyIndex;
+    earlyIndex.reserve (transactions.size());
+    for (TransactionStatus const& e : transactions)
+    {
+        auto const& stx = e.transaction->getSTransaction();
+        if (stx->isAjmChainTableType() ||
+            STTx::checkAjmchainContractType(stx->getTxnType()))
+        {
+            earlyIndex.push_back (-1);
+            continue;
+        }
+        earlyIndex.push_back (early.size());
+        early.emplace_back (stx, applyFlags(e));
+    }
+    auto const pfresults = preflightBatch (app_,
+        app_.openLedger().current()->rules(), early,
+            app_.journal("OpenLedger"));
+    endStage (ApplyAccounting::preflight);
+
     {
         auto lock = make_lock(app_.getMasterMutex());
         bool changed = false;
         {
             std::lock_guard <std::recursive_mutex> lock (
                 m_ledgerMaster.peekMutex());
+            endStage (ApplyAccounting::lockWait);
 
             app_.openLedger().modify(
                 [&](OpenView& view, beast::Journal j)
             {
-                for (TransactionStatus& e : transactions)
+                for (std::size_t i = 0; i < transactions.size(); ++i)
                 {
-                    // we check before addingto the batch
-                    ApplyFlags flags = tapNO_CHECK_SIGN;
-                    if (e.local)
-                        flags = flags | tapFromClient;
-                    else
-                        flags = flags | tapByRelay;
-
-                    if (e.admin)
-                        flags = flags | tapUNLIMITED;
-
-                    auto const result = app_.getTxQ().apply(
-                        app_, view, e.transaction->getSTransaction(),
-                        flags, j);
+                    TransactionStatus& e = transactions[i];
+                    auto const& stx = e.transaction->getSTransaction();
+
+                    auto const result = (earlyIndex[i] < 0)
+                        ? app_.getTxQ().apply(
+                            app_, view, stx, applyFlags(e), j)
+                        : app_.getTxQ().apply(
+                            app_, view, stx, pfresults[earlyIndex[i]], j);
                     e.result = result.first;
                     e.applied = result.second;
 
@@ -1181,6 +1369,7 @@ void NetworkOPsImp::apply (std::unique_lock<std::mutex>& batchLock)
                 }
                 return changed;
             });
+            endStage (ApplyAccounting::apply);
         }
         if (changed)
             reportFeeChange();
@@ -1309,6 +1498,9 @@ void NetworkOPsImp::apply (std::unique_lock<std::mutex>& batchLock)
         }
     }
 
+    endStage (ApplyAccounting::finish);
+    applyAccounting_.record (transactions.size(), durations);
+
     batchLock.lock();
 
     for (TransactionStatus& e : transactions)
@@ -1657,6 +1849,30 @@ void NetworkOPsImp::processTrustedProposal (
         JLOG(m_journal.info()) << "Not relaying trusted proposal";
 }
 
+void NetworkOPsImp::processTrustedProposals (
+    std::vector<std::pair<RCLCxPeerPos,
+        std::shared_ptr<protocol::TMProposeSet>>> const& proposals)
+{
+    std::vector<RCLCxPeerPos> peerPos;
+    peerPos.reserve (proposals.size ());
+    for (auto const& p : proposals)
+        peerPos.push_back (p.first);
+
+    auto const relay = mConsensus.peerProposals(
+        app_.timeKeeper().closeTime(), peerPos);
+
+    for (std::size_t i = 0; i < proposals.size (); ++i)
+    {
+        if (relay[i])
+        {
+            app_.overlay().relay(*proposals[i].second,
+                proposals[i].first.suppressionID());
+        }
+        else
+            JLOG(m_journal.info()) << "Not relaying trusted proposal";
+    }
+}
+
 void
 NetworkOPsImp::mapComplete (
     std::shared_ptr<SHAMap> const& map, bool fromAcquire)
@@ -2074,9 +2290,10 @@ NetworkOPsImp::transactionsSQL (
         sql =
             boost::str (boost::format (
                 "SELECT %s FROM AccountTransactions "
-                "WHERE Account = '%s' %s %s LIMIT %u, %u;")
+                "WHERE Account = %s %s %s LIMIT %u, %u;")
             % selection
-            % app_.accountIDCache().toBase58(account)
+            % txnDBLiteral (app_.getTxnDBVersion (), account,
+                app_.accountIDCache ())
             % maxClause
             % minClause
             % beast::lexicalCastThrow <std::string> (offset)
@@ -2088,17 +2305,15 @@ NetworkOPsImp::transactionsSQL (
                 "SELECT %s FROM "
                 "AccountTransactions INNER JOIN Transactions "
                 "ON Transactions.TransID = AccountTransactions.TransID "
-                "WHERE Account = '%s' %s %s "
-                "ORDER BY AccountTransactions.LedgerSeq %s, "
-                "AccountTransactions.TxnSeq %s, AccountTransactions.TransID %s "
+                "WHERE Account = %s %s %s "
+                "ORDER BY %s "
                 "LIMIT %u, %u;")
                     % selection
-                    % app_.accountIDCache().toBase58(account)
+                    % txnDBLiteral (app_.getTxnDBVersion (), account,
+                        app_.accountIDCache ())
                     % maxClause
                     % minClause
-                    % (descending ? "DESC" : "ASC")
-                    % (descending ? "DESC" : "ASC")
-                    % (descending ? "DESC" : "ASC")
+                    % txnDBAccountOrder (app_.getTxnDBVersion (), descending)
                     % beast::lexicalCastThrow <std::string> (offset)
                     % beast::lexicalCastThrow <std::string> (numberOfResults)
                    );
@@ -2106,6 +2321,18 @@ NetworkOPsImp::transactionsSQL (
     return sql;
 }
 
+bool
+NetworkOPsImp::useAccountHistory (
+    std::int32_t minLedger, std::int32_t maxLedger)
+{
+    auto const history = app_.getAccountHistory ();
+    if (! history)
+        return false;
+
+    return minLedger >= 0 && maxLedger >= minLedger &&
+        history->covers (minLedger, maxLedger);
+}
+
 NetworkOPs::AccountTxs NetworkOPsImp::getAccountTxs (
     AccountID const& account,
     std::int32_t minLedger, std::int32_t maxLedger, bool descending,
@@ -2244,11 +2471,16 @@ NetworkOPsImp::getTxsAccount (
             ret, ledger_index, status, rawTxn, rawMeta, app);
     };
 
-    accountTxPage(app_.getTxnDB (), app_.accountIDCache(),
-        std::bind(saveLedgerAsync, std::ref(app_),
-            std::placeholders::_1), bound, account, minLedger,
-                maxLedger, forward, token, limit, bUnlimited,
-                    page_length);
+    if (useAccountHistory (minLedger, maxLedger))
+        app_.getAccountHistory ()->page (bound, account, minLedger,
+            maxLedger, forward, token, limit, bUnlimited, page_length);
+    else
+        accountTxPage(app_.getTxnDB (), app_.getTxnDBVersion (),
+            app_.accountIDCache(),
+            std::bind(saveLedgerAsync, std::ref(app_),
+                std::placeholders::_1), bound, account, minLedger,
+                    maxLedger, forward, token, limit, bUnlimited,
+                        page_length);
 
     return ret;
 }
@@ -2272,11 +2504,16 @@ NetworkOPsImp::getTxsAccountB (
         ret.emplace_back (strHex(rawTxn), strHex (rawMeta), ledgerIndex);
     };
 
-    accountTxPage(app_.getTxnDB (), app_.accountIDCache(),
-        std::bind(saveLedgerAsync, std::ref(app_),
-            std::placeholders::_1), bound, account, minLedger,
-                maxLedger, forward, token, limit, bUnlimited,
-                    page_length);
+    if (useAccountHistory (minLedger, maxLedger))
+        app_.getAccountHistory ()->page (bound, account, minLedger,
+            maxLedger, forward, token, limit, bUnlimited, page_length);
+    else
+        accountTxPage(app_.getTxnDB (), app_.getTxnDBVersion (),
+            app_.accountIDCache(),
+            std::bind(saveLedgerAsync, std::ref(app_),
+                std::placeholders::_1), bound, account, minLedger,
+                    maxLedger, forward, token, limit, bUnlimited,
+                        page_length);
     return ret;
 }
 
@@ -2289,6 +2526,19 @@ bool NetworkOPsImp::recvValidation (
     return handleNewValidation(app_, val, source);
 }
 
+std::vector<bool> NetworkOPsImp::recvValidations (
+    std::vector<std::pair<STValidation::pointer, std::string>> const& vals)
+{
+    for (auto const& v : vals)
+    {
+        JLOG(m_journal.debug()) << "recvValidation "
+                              << v.first->getLedgerHash ()
+                              << " from " << v.second;
+        pubValidation (v.first);
+    }
+    return handleNewValidations(app_, vals);
+}
+
 Json::Value NetworkOPsImp::getConsensusInfo ()
 {
     return mConsensus.getJson (true);
@@ -2542,6 +2792,8 @@ Json::Value NetworkOPsImp::getServerInfo (bool human, bool admin)
     }
 
     info[jss::state_accounting] = accounting_.json();
+    if (admin)
+        info[jss::apply_stages] = applyAccounting_.json();
     info[jss::uptime] = UptimeTimer::getInstance ().getElapsedSeconds ();
 
     return info;
@@ -3868,6 +4120,42 @@ Json::Value NetworkOPsImp::StateAccounting::json() const
 
 //------------------------------------------------------------------------------
 
+void NetworkOPsImp::ApplyAccounting::record (
+    std::size_t transactions, Durations const& durations)
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    ++batches_;
+    transactions_ += transactions;
+    for (std::size_t i = 0; i < stageCount; ++i)
+        durations_[i] += durations[i];
+}
+
+Json::Value NetworkOPsImp::ApplyAccounting::json() const
+{
+    std::unique_lock<std::mutex> lock (mutex_);
+
+    auto const batches = batches_;
+    auto const transactions = transactions_;
+    auto const durations = durations_;
+
+    lock.unlock();
+
+    Json::Value ret = Json::objectValue;
+    ret[jss::batches] = std::to_string (batches);
+    ret[jss::transactions] = std::to_string (transactions);
+
+    for (std::size_t i = 0; i < stageCount; ++i)
+    {
+        ret[stages_[i]] = Json::objectValue;
+        ret[stages_[i]][jss::duration_us] =
+            std::to_string (durations[i].count());
+    }
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+
 std::unique_ptr<NetworkOPs>
 make_NetworkOPs (Application& app, NetworkOPs::clock_type& clock,
     bool standalone, std::size_t network_quorum, bool startvalid,
@@ -30,6 +30,7 @@ OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 #include <memory>
 #include <deque>
 #include <tuple>
+#include <vector>
 
 #include "ripple.pb.h"
 
@@ -126,6 +127,19 @@ namespace ripple {
 		virtual void processTransaction(std::shared_ptr<Transaction>& transaction,
 			bool bUnlimited, bool bLocal, FailHard failType) = 0;
 
+		/**
+		* Process a set of client submitted transactions together. They are
+		* applied in as few batches as possible, and this returns once all of
+		* them have been applied. Signatures must already have been checked.
+		*
+		* @param transactions Transaction objects, canonicalized in place.
+		* @param bUnlimited Whether a privileged client connection submitted them.
+		* @param failType fail_hard setting from transaction submission.
+		*/
+		virtual void processTransactionSet(
+			std::vector<std::shared_ptr<Transaction>>& transactions,
+			bool bUnlimited, FailHard failType) = 0;
+
 		//--------------------------------------------------------------------------
 		//
 		// Owner functions
@@ -158,6 +172,27 @@ namespace ripple {
 		virtual bool recvValidation(STValidation::ref val,
 			std::string const& source) = 0;
 
+		/**
+		* Process a batch of trusted proposals with one acquisition of the
+		* consensus lock, relaying each one that consensus accepts.
+		*
+		* @param proposals Each proposal and the message it arrived in.
+		*/
+		virtual void processTrustedProposals(
+			std::vector<std::pair<RCLCxPeerPos,
+				std::shared_ptr<protocol::TMProposeSet>>> const& proposals) = 0;
+
+		/**
+		* Receive a batch of validations, adding them to the validation set
+		* with one acquisition of its lock.
+		*
+		* @param vals Each validation, with the source used in logging.
+		* @return Whether each validation should be relayed, in order.
+		*/
+		virtual std::vector<bool> recvValidations(
+			std::vector<std::pair<STValidation::pointer,
+				std::string>> const& vals) = 0;
+
 		virtual void mapComplete(std::shared_ptr<SHAMap> const& map,
 			bool fromAcquire) = 0;
 
@@ -21,6 +21,7 @@
 
 #include <ripple/app/misc/SHAMapStoreImp.h>
 #include <ripple/app/ledger/TransactionMaster.h>
+#include <ripple/app/misc/AccountHistory.h>
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/core/ConfigSections.h>
 #include <ripple/beast/core/CurrentThreadName.h>
@@ -730,6 +731,9 @@ SHAMapStoreImp::clearPrior (LedgerIndex lastRotated)
         "DELETE FROM AccountTransactions WHERE LedgerSeq < %u;");
     if (health())
         return;
+
+    if (auto history = app_.getAccountHistory ())
+        history->deleteBefore (lastRotated);
 }
 
 SHAMapStoreImp::Health
@@ -27,6 +27,8 @@
 #include <ripple/protocol/STTx.h>
 #include <boost/intrusive/set.hpp>
 #include <boost/circular_buffer.hpp>
+#include <memory>
+#include <mutex>
 
 namespace ripple {
 
@@ -126,6 +128,18 @@ public:
         std::shared_ptr<STTx const> const& tx,
             ApplyFlags flags, beast::Journal j);
 
+    /**
+        Same as above, for a transaction that has already been
+        through `preflight`, e.g. outside of the ledger locks.
+        The flags are taken from `pfresult`.
+
+        @see preflightBatch
+    */
+    std::pair<STer, bool>
+    apply(Application& app, OpenView& view,
+        std::shared_ptr<STTx const> const& tx,
+            PreflightResult const& pfresult, beast::Journal j);
+
     /**
         Fill the new open ledger with transactions from the queue.
         As we apply more transactions to the ledger, the required
@@ -406,10 +420,51 @@ private:
     boost::optional<size_t> maxSize_;
 
     // Most queue operations are done under the master lock,
-    // but use this mutex for the RPC "fee" command, which isn't.
+    // but use this mutex for the RPC queries, which aren't.
     std::mutex mutable mutex_;
 
+    /** The queue state reported by `getMetrics`.
+
+        Republished at the end of every operation that changes the
+        queue or the fee metrics, so the `fee` RPC command never
+        waits on `mutex_`.
+    */
+    struct MetricsSnapshot
+    {
+        FeeMetrics::Snapshot fees;
+        std::size_t txCount;
+        boost::optional<std::size_t> maxSize;
+        std::uint64_t minFeeLevel;
+    };
+
+    // Replaced under mutex_, read with std::atomic_load
+    std::shared_ptr<MetricsSnapshot const> metrics_;
+
+    // Publishes the metrics snapshot when a locked
+    // operation on the queue completes.
+    class MetricsPublisher
+    {
+    private:
+        TxQ& txq_;
+
+    public:
+        explicit
+        MetricsPublisher(TxQ& txq)
+            : txq_(txq)
+        {
+        }
+
+        ~MetricsPublisher()
+        {
+            txq_.publishMetrics();
+        }
+    };
+
 private:
+    // Must be called with mutex_ locked
+    void
+    publishMetrics();
+
     template<size_t fillPercentage = 100>
     bool
     isFull() const;
@@ -0,0 +1,530 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/misc/AccountHistory.h>
+#include <ripple/basics/contract.h>
+#include <ripple/protocol/JsonFields.h>
+#include <ripple/protocol/STTx.h>
+#include <ripple/protocol/Serializer.h>
+#include <ripple/unity/rocksdb.h>
+#include <boost/algorithm/string/predicate.hpp>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace ripple {
+
+#if RIPPLE_ROCKSDB_AVAILABLE
+
+namespace {
+
+// Key layout. Integers are big-endian so keys sort numerically.
+//
+//   'A' account ledgerSeq txnSeq   (empty)
+//   'T' ledgerSeq txnSeq           rawTxn, rawMeta, affected accounts
+//   'R'                            first and last ledger covered
+char const accountPrefix = 'A';
+char const txPrefix = 'T';
+char const rangeKey[] = "R";
+
+void
+appendUInt32 (std::string& s, std::uint32_t v)
+{
+    s.push_back (static_cast<char> (v >> 24));
+    s.push_back (static_cast<char> (v >> 16));
+    s.push_back (static_cast<char> (v >> 8));
+    s.push_back (static_cast<char> (v));
+}
+
+std::uint32_t
+readUInt32 (char const* p)
+{
+    auto const u = reinterpret_cast<unsigned char const*> (p);
+    return (std::uint32_t (u[0]) << 24) | (std::uint32_t (u[1]) << 16) |
+        (std::uint32_t (u[2]) << 8) | std::uint32_t (u[3]);
+}
+
+std::string
+accountKey (AccountID const& account)
+{
+    std::string key (1, accountPrefix);
+    key.append (reinterpret_cast<char const*> (account.data ()),
+        account.size ());
+    return key;
+}
+
+std::string
+accountKey (AccountID const& account,
+    std::uint32_t ledgerSeq, std::uint32_t txnSeq)
+{
+    auto key = accountKey (account);
+    appendUInt32 (key, ledgerSeq);
+    appendUInt32 (key, txnSeq);
+    return key;
+}
+
+std::string
+txKey (std::uint32_t ledgerSeq, std::uint32_t txnSeq)
+{
+    std::string key (1, txPrefix);
+    appendUInt32 (key, ledgerSeq);
+    appendUInt32 (key, txnSeq);
+    return key;
+}
+
+bool
+startsWith (rocksdb::Slice const& s, std::string const& prefix)
+{
+    return s.size () >= prefix.size () &&
+        std::memcmp (s.data (), prefix.data (), prefix.size ()) == 0;
+}
+
+std::size_t const accountKeySize = 1 + 20 + 4 + 4;
+std::size_t const txKeySize = 1 + 4 + 4;
+
+// Rows removed per write batch by deleteBefore
+std::size_t const deleteBatch = 10000;
+
+// How far past the covered range a ledger may be saved before the
+// ones missing in between are given up on
+LedgerIndex const maxGap = 256;
+
+} // namespace
+
+class AccountHistoryImp
+    : public AccountHistory
+{
+private:
+    beast::Journal j_;
+    std::unique_ptr<rocksdb::DB> db_;
+
+    // Serializes saves and deletes, which read what they replace
+    std::mutex writeMutex_;
+
+    // The ledgers [lo_, hi_] are held completely, none if hi_ is 0
+    mutable std::mutex rangeMutex_;
+    LedgerIndex lo_ = 0;
+    LedgerIndex hi_ = 0;
+
+    // Ledgers saved past hi_ + 1, waiting for the ones in between.
+    // Guarded by writeMutex_.
+    std::set<LedgerIndex> ahead_;
+
+public:
+    AccountHistoryImp (Section const& section, beast::Journal journal)
+        : j_ (journal)
+    {
+        std::string path;
+        if (! get_if_exists (section, "path", path))
+            Throw<std::runtime_error> (
+                "Missing path in [account_history_db]");
+
+        rocksdb::Options options;
+        options.create_if_missing = true;
+
+        rocksdb::BlockBasedTableOptions table_options;
+        if (section.exists ("cache_mb"))
+            table_options.block_cache = rocksdb::NewLRUCache (
+                get<int>(section, "cache_mb") * 1024L * 1024L);
+        options.table_factory.reset (
+            NewBlockBasedTableFactory (table_options));
+
+        rocksdb::DB* db = nullptr;
+        rocksdb::Status status = rocksdb::DB::Open (options, path, &db);
+        if (! status.ok () || ! db)
+            Throw<std::runtime_error> (
+                std::string ("Unable to open/create account history: ") +
+                    status.ToString ());
+        db_.reset (db);
+
+        std::string value;
+        if (db_->Get (rocksdb::ReadOptions (), rangeKey, &value).ok () &&
+                value.size () == 8)
+        {
+            lo_ = readUInt32 (value.data ());
+            hi_ = readUInt32 (value.data () + 4);
+        }
+    }
+
+    void
+    saveLedger (LedgerIndex seq, std::vector<Entry> const& entries) override
+    {
+        std::lock_guard<std::mutex> lock (writeMutex_);
+
+        rocksdb::WriteBatch batch;
+        removeLedgers (batch, seq, seq + 1);
+
+        for (auto const& e : entries)
+        {
+            Serializer s (e.rawTxn.size () + e.rawMeta.size () +
+                e.accounts.size () * 20 + 8);
+            s.addVL (e.rawTxn);
+            s.addVL (e.rawMeta);
+            for (auto const& account : e.accounts)
+            {
+                s.addBitString (account);
+                batch.Put (accountKey (account, seq, e.txnSeq),
+                    rocksdb::Slice ());
+            }
+            batch.Put (txKey (seq, e.txnSeq), rocksdb::Slice (
+                reinterpret_cast<char const*> (s.data ()), s.size ()));
+        }
+
+        LedgerIndex lo, hi;
+        std::tie (lo, hi) = range ();
+        auto ahead = ahead_;
+
+        if (hi == 0)
+        {
+            lo = hi = seq;
+        }
+        else if (seq + 1 == lo)
+        {
+            lo = seq;
+        }
+        else if (seq == hi + 1)
+        {
+            hi = seq;
+        }
+        else if (seq > hi + 1)
+        {
+            ahead.insert (seq);
+            if (seq - hi > maxGap)
+            {
+                // Start again from the run of saved ledgers ending here
+                for (lo = seq; ahead.count (lo - 1); --lo)
+                    ;
+                hi = seq;
+                ahead.erase (ahead.begin (), ahead.upper_bound (seq));
+            }
+        }
+        while (ahead.erase (hi + 1))
+            ++hi;
+
+        putRange (batch, lo, hi);
+
+        auto const status = db_->Write (rocksdb::WriteOptions (), &batch);
+        if (! status.ok ())
+        {
+            JLOG (j_.error()) << "Saving ledger " << seq <<
+                " to the account history failed: " << status.ToString ();
+
+            // What is stored for this ledger, if anything, is stale
+            ahead_.erase (seq);
+            std::tie (lo, hi) = range ();
+            if (seq >= lo && seq <= hi)
+            {
+                if (seq == hi)
+                    lo = hi = 0;
+                else
+                    lo = seq + 1;
+                setRange (lo, hi);
+            }
+            return;
+        }
+
+        ahead_ = std::move (ahead);
+        std::lock_guard<std::mutex> rangeLock (rangeMutex_);
+        lo_ = lo;
+        hi_ = hi;
+    }
+
+    void
+    deleteBefore (LedgerIndex seq) override
+    {
+        std::lock_guard<std::mutex> lock (writeMutex_);
+
+        ahead_.erase (ahead_.begin (), ahead_.lower_bound (seq));
+
+        // Stop answering for the ledgers before they go
+        LedgerIndex lo, hi;
+        std::tie (lo, hi) = range ();
+        if (hi != 0 && lo < seq)
+        {
+            if (hi < seq)
+                lo = hi = 0;
+            else
+                lo = seq;
+            setRange (lo, hi);
+        }
+
+        // Backfilled ledgers may lie below the covered range, so
+        // start from the lowest one actually stored.
+        for (auto first = firstStored (); first < seq;)
+        {
+            rocksdb::WriteBatch batch;
+            first = removeLedgers (batch, first, seq, deleteBatch);
+
+            auto const status = db_->Write (rocksdb::WriteOptions (), &batch);
+            if (! status.ok ())
+            {
+                JLOG (j_.error()) << "Deleting from the account history "
+                    "failed: " << status.ToString ();
+                return;
+            }
+        }
+    }
+
+    bool
+    covers (LedgerIndex minLedger, LedgerIndex maxLedger) const override
+    {
+        std::lock_guard<std::mutex> lock (rangeMutex_);
+        return hi_ != 0 && minLedger >= lo_ && maxLedger <= hi_;
+    }
+
+    void
+    page (
+        OnTransaction const& onTransaction,
+        AccountID const& account,
+        std::int32_t minLedger,
+        std::int32_t maxLedger,
+        bool forward,
+        Json::Value& token,
+        int limit,
+        bool bAdmin,
+        std::uint32_t pageLength) override
+    {
+        bool const hasMarker = ! token.isNull () && token.isObject ();
+
+        std::uint32_t numberOfResults;
+        if (limit <= 0 || (limit > pageLength && ! bAdmin))
+            numberOfResults = pageLength;
+        else
+            numberOfResults = limit;
+
+        std::uint32_t findLedger = 0, findSeq = 0;
+        if (hasMarker)
+        {
+            try
+            {
+                if (! token.isMember (jss::ledger) ||
+                        ! token.isMember (jss::seq))
+                    return;
+                findLedger = token[jss::ledger].asInt ();
+                findSeq = token[jss::seq].asInt ();
+            }
+            catch (std::exception const&)
+            {
+                return;
+            }
+        }
+
+        token = Json::nullValue;
+
+        std::uint32_t const lo = minLedger < 0 ? 0 : minLedger;
+        std::uint32_t const hi = maxLedger < 0 ?
+            std::numeric_limits<std::uint32_t>::max () : maxLedger;
+
+        auto const prefix = accountKey (account);
+        std::string start;
+        if (hasMarker)
+            start = accountKey (account, findLedger, findSeq);
+        else if (forward)
+            start = accountKey (account, lo, 0);
+        else
+            start = accountKey (account, hi,
+                std::numeric_limits<std::uint32_t>::max ());
+
+        rocksdb::ReadOptions options;
+        options.snapshot = db_->GetSnapshot ();
+
+        std::unique_ptr<rocksdb::Iterator> it (db_->NewIterator (options));
+        it->Seek (start);
+        if (! forward)
+        {
+            // Step back to the last key not after the start
+            if (! it->Valid ())
+                it->SeekToLast ();
+            else if (it->key () != rocksdb::Slice (start))
+                it->Prev ();
+        }
+
+        std::string const status (1, TXN_SQL_VALIDATED);
+        std::string value;
+        Blob rawTxn;
+        Blob rawMeta;
+
+        for (; it->Valid (); forward ? it->Next () : it->Prev ())
+        {
+            auto const key = it->key ();
+            if (! startsWith (key, prefix) || key.size () != accountKeySize)
+                break;
+
+            auto const ledgerSeq = readUInt32 (key.data () + 21);
+            auto const txnSeq = readUInt32 (key.data () + 25);
+            if (forward ? ledgerSeq > hi : ledgerSeq < lo)
+                break;
+
+            if (numberOfResults == 0)
+            {
+                token = Json::objectValue;
+                token[jss::ledger] = ledgerSeq;
+                token[jss::seq] = txnSeq;
+                break;
+            }
+
+            if (! db_->Get (options, txKey (ledgerSeq, txnSeq), &value).ok ())
+            {
+                JLOG (j_.warn()) << "Account history has no transaction " <<
+                    ledgerSeq << ":" << txnSeq;
+                continue;
+            }
+
+            SerialIter sit (value.data (), value.size ());
+            rawTxn = sit.getVL ();
+            rawMeta = sit.getVL ();
+
+            onTransaction (ledgerSeq, status, rawTxn, rawMeta);
+            --numberOfResults;
+        }
+
+        it.reset ();
+        db_->ReleaseSnapshot (options.snapshot);
+    }
+
+private:
+    std::pair<LedgerIndex, LedgerIndex>
+    range () const
+    {
+        std::lock_guard<std::mutex> lock (rangeMutex_);
+        return {lo_, hi_};
+    }
+
+    static
+    void
+    putRange (rocksdb::WriteBatch& batch, LedgerIndex lo, LedgerIndex hi)
+    {
+        std::string value;
+        appendUInt32 (value, lo);
+        appendUInt32 (value, hi);
+        batch.Put (rangeKey, value);
+    }
+
+    // Shrink the covered range, in memory even if it cannot be stored
+    void
+    setRange (LedgerIndex lo, LedgerIndex hi)
+    {
+        {
+            std::lock_guard<std::mutex> lock (rangeMutex_);
+            lo_ = lo;
+            hi_ = hi;
+        }
+
+        rocksdb::WriteBatch batch;
+        putRange (batch, lo, hi);
+        auto const status = db_->Write (rocksdb::WriteOptions (), &batch);
+        if (! status.ok ())
+            JLOG (j_.error()) << "Saving the account history range "
+                "failed: " << status.ToString ();
+    }
+
+    // The lowest ledger with a transaction stored, or the largest
+    // sequence if there is none.
+    LedgerIndex
+    firstStored ()
+    {
+        std::unique_ptr<rocksdb::Iterator> it (
+            db_->NewIterator (rocksdb::ReadOptions ()));
+        it->Seek (txKey (0, 0));
+        if (! it->Valid () || it->key ().size () != txKeySize ||
+                it->key ().data ()[0] != txPrefix)
+            return std::numeric_limits<LedgerIndex>::max ();
+        return readUInt32 (it->key ().data () + 1);
+    }
+
+    // Add to `batch` the removal of the ledgers in [lo, hi),
+    // stopping after `maxTx` transactions. Returns the first
+    // ledger not entirely removed.
+    LedgerIndex
+    removeLedgers (rocksdb::WriteBatch& batch,
+        LedgerIndex lo, LedgerIndex hi,
+        std::size_t maxTx = std::numeric_limits<std::size_t>::max ())
+    {
+        auto const end = txKey (hi, 0);
+        std::unique_ptr<rocksdb::Iterator> it (
+            db_->NewIterator (rocksdb::ReadOptions ()));
+
+        std::size_t count = 0;
+        LedgerIndex last = lo;
+        for (it->Seek (txKey (lo, 0));
+            it->Valid () && it->key ().compare (end) < 0; it->Next ())
+        {
+            auto const key = it->key ();
+            if (key.size () != txKeySize)
+                continue;
+
+            auto const ledgerSeq = readUInt32 (key.data () + 1);
+            auto const txnSeq = readUInt32 (key.data () + 5);
+            if (count >= maxTx && ledgerSeq != last)
+                return ledgerSeq;
+            last = ledgerSeq;
+
+            SerialIter sit (it->value ().data (), it->value ().size ());
+            sit.skip (sit.getVLDataLength ());
+            sit.skip (sit.getVLDataLength ());
+            while (sit.getBytesLeft () >= 20)
+                batch.Delete (accountKey (
+                    sit.getBitString<160, detail::AccountIDTag> (),
+                    ledgerSeq, txnSeq));
+
+            batch.Delete (key);
+            ++count;
+        }
+
+        return hi;
+    }
+};
+
+std::unique_ptr<AccountHistory>
+make_AccountHistory (Section const& section, beast::Journal journal)
+{
+    if (section.lines ().empty ())
+        return nullptr;
+
+    std::string type;
+    if (get_if_exists (section, "type", type) &&
+            ! boost::iequals (type, "rocksdb"))
+        Throw<std::runtime_error> (
+            "Unsupported type in [account_history_db]: " + type);
+
+    return std::make_unique<AccountHistoryImp> (section, journal);
+}
+
+#else
+
+std::unique_ptr<AccountHistory>
+make_AccountHistory (Section const& section, beast::Journal)
+{
+    if (section.lines ().empty ())
+        return nullptr;
+
+    Throw<std::runtime_error> (
+        "[account_history_db] requires RocksDB, which is not available");
+    return nullptr;
+}
+
+#endif
+
+} // ripple
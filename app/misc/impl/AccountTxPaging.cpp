@@ -21,6 +21,7 @@
 #include <ripple/app/ledger/LedgerToJson.h>
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/main/Application.h>
+#include <ripple/app/main/DBInit.h>
 #include <ripple/app/misc/Transaction.h>
 #include <ripple/app/misc/impl/AccountTxPaging.h>
 #include <ripple/protocol/Serializer.h>
@@ -64,6 +65,7 @@ saveLedgerAsync (Application& app, std::uint32_t seq)
 void
 accountTxPage (
     DatabaseCon& connection,
+    int txnDBVersion,
     AccountIDCache const& idCache,
     std::function<void (std::uint32_t)> const& onUnsavedLedger,
     std::function<void (std::uint32_t,
@@ -120,9 +122,10 @@ accountTxPage (
           Status,RawTxn,TxnMeta
           FROM AccountTransactions INNER JOIN Transactions
           ON Transactions.TransID = AccountTransactions.TransID
-          AND AccountTransactions.Account = '%s' WHERE
+          AND AccountTransactions.Account = %s WHERE
           )");
 
+    auto const literal = txnDBLiteral (txnDBVersion, account, idCache);
     std::string sql;
 
     // SQL's BETWEEN uses a closed interval ([a,b])
@@ -135,7 +138,7 @@ accountTxPage (
              ORDER BY AccountTransactions.LedgerSeq ASC,
              AccountTransactions.TxnSeq ASC
              LIMIT %u;)"))
-            % idCache.toBase58(account)
+            % literal
             % minLedger
             % maxLedger
             % queryLimit);
@@ -152,7 +155,7 @@ accountTxPage (
             AccountTransactions.TxnSeq ASC
             LIMIT %u;
             )"))
-        % idCache.toBase58(account)
+        % literal
         % (findLedger + 1)
         % maxLedger
         % findLedger
@@ -167,7 +170,7 @@ accountTxPage (
              ORDER BY AccountTransactions.LedgerSeq DESC,
              AccountTransactions.TxnSeq DESC
              LIMIT %u;)"))
-            % idCache.toBase58(account)
+            % literal
             % minLedger
             % maxLedger
             % queryLimit);
@@ -182,7 +185,7 @@ accountTxPage (
              ORDER BY AccountTransactions.LedgerSeq DESC,
              AccountTransactions.TxnSeq DESC
              LIMIT %u;)"))
-            % idCache.toBase58(account)
+            % literal
             % minLedger
             % (findLedger - 1)
             % findLedger
@@ -46,6 +46,7 @@ saveLedgerAsync (Application& app, std::uint32_t seq);
 void
 accountTxPage (
     DatabaseCon& database,
+    int txnDBVersion,
     AccountIDCache const& idCache,
     std::function<void (std::uint32_t)> const& onUnsavedLedger,
     std::function<void (std::uint32_t,
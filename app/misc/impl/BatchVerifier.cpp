@@ -0,0 +1,154 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/app/misc/BatchVerifier.h>
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/main/Application.h>
+#include <ripple/app/misc/HashRouter.h>
+#include <ripple/app/tx/apply.h>
+#include <ripple/basics/Log.h>
+#include <ripple/core/JobQueue.h>
+#include <ripple/protocol/PublicKey.h>
+#include <algorithm>
+#include <iterator>
+#include <thread>
+
+namespace ripple {
+
+// Largest number of transactions verified together
+static std::size_t const maxBatch = 64;
+
+// Queued transactions per running job before another one starts
+static std::size_t const minBatch = 8;
+
+// Only a single Ed25519 signature has a batch check
+static bool
+batchable (STTx const& tx)
+{
+    auto const type = publicKeyType (
+        makeSlice (tx.getFieldVL (sfSigningPubKey)));
+    return type && *type == KeyType::ed25519;
+}
+
+BatchVerifier::BatchVerifier (Application& app, beast::Journal j)
+    : app_ (app)
+    , j_ (j)
+{
+}
+
+void
+BatchVerifier::add (
+    std::shared_ptr<STTx const> const& stx, Handler handler)
+{
+    if (! batchable (*stx))
+    {
+        post (std::move (handler));
+        return;
+    }
+
+    {
+        static std::size_t const maxJobs =
+            std::max (std::thread::hardware_concurrency(), 2u);
+
+        std::lock_guard<std::mutex> lock (mutex_);
+        pending_.emplace_back (stx, std::move (handler));
+
+        // Start another job once the running ones
+        // have a few transactions each to work on.
+        if (jobs_ >= maxJobs || pending_.size() <= jobs_ * minBatch)
+            return;
+        ++jobs_;
+    }
+
+    if (! app_.getJobQueue().addJob (jtTRANSACTION,
+            "BatchVerifier", [this](Job&) { run(); }))
+    {
+        // Shutting down; nobody is going to look at the results
+        std::lock_guard<std::mutex> lock (mutex_);
+        --jobs_;
+    }
+}
+
+void
+BatchVerifier::post (Handler handler)
+{
+    app_.getJobQueue().addJob (jtTRANSACTION,
+        "recvTransaction->checkTransaction",
+        [j = j_, handler = std::move (handler)](Job&)
+        {
+            try
+            {
+                handler();
+            }
+            catch (std::exception const& e)
+            {
+                JLOG (j.warn()) << "Verified transaction handler: "
+                    << e.what();
+            }
+        });
+}
+
+std::size_t
+BatchVerifier::size() const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    return pending_.size();
+}
+
+void
+BatchVerifier::run()
+{
+    std::vector<std::pair<std::shared_ptr<STTx const>, Handler>> batch;
+    std::vector<std::shared_ptr<STTx const>> txs;
+
+    for (;;)
+    {
+        batch.clear();
+        {
+            std::lock_guard<std::mutex> lock (mutex_);
+            if (pending_.empty())
+            {
+                --jobs_;
+                return;
+            }
+            // Leave a share of the queue for each of the other jobs
+            auto const n = std::min (maxBatch,
+                (pending_.size() + jobs_ - 1) / jobs_);
+            std::move (pending_.begin(), pending_.begin() + n,
+                std::back_inserter (batch));
+            pending_.erase (pending_.begin(), pending_.begin() + n);
+        }
+
+        txs.clear();
+        for (auto const& item : batch)
+            txs.push_back (item.first);
+
+        checkSignatures (app_.getHashRouter(), txs,
+            app_.getLedgerMaster().getValidatedRules());
+
+        JLOG (j_.trace()) << "Verified " << batch.size() << " signatures";
+
+        for (auto& item : batch)
+            post (std::move (item.second));
+    }
+}
+
+} // ripple
@@ -24,6 +24,7 @@
 #include <ripple/core/DatabaseCon.h>
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/main/Application.h>
+#include <ripple/app/main/DBInit.h>
 #include <ripple/app/misc/HashRouter.h>
 #include <ripple/protocol/Feature.h>
 #include <ripple/protocol/JsonFields.h>
@@ -120,9 +121,9 @@ Transaction::pointer Transaction::transactionFromSQLValidated(
 Transaction::pointer Transaction::load(uint256 const& id, Application& app)
 {
     std::string sql = "SELECT LedgerSeq,Status,RawTxn "
-            "FROM Transactions WHERE TransID='";
-    sql.append (to_string (id));
-    sql.append ("';");
+            "FROM Transactions WHERE TransID=";
+    sql.append (txnDBLiteral (app.getTxnDBVersion (), id));
+    sql.append (";");
 
     boost::optional<std::uint64_t> ledgerSeq;
     boost::optional<std::string> status;
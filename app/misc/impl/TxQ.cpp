@@ -322,6 +322,7 @@ TxQ::TxQ(Setup const& setup,
     , feeMetrics_(setup, j)
     , maxSize_(boost::none)
 {
+    publishMetrics();
 }
 
 TxQ::~TxQ()
@@ -340,6 +341,33 @@ TxQ::isFull() const
         (*maxSize_ * fillPercentage / 100);
 }
 
+void
+TxQ::publishMetrics()
+{
+    auto const fees = feeMetrics_.getSnapshot();
+    auto const txCount = byFee_.size();
+    auto const minFeeLevel = isFull() ?
+        byFee_.rbegin()->feeLevel + 1 : baseLevel;
+
+    // Most calls (e.g. rejected transactions) change nothing,
+    // so avoid replacing the snapshot for them.
+    auto const current = std::atomic_load(&metrics_);
+    if (current &&
+        current->fees.txnsExpected == fees.txnsExpected &&
+        current->fees.escalationMultiplier == fees.escalationMultiplier &&
+        current->txCount == txCount &&
+        current->maxSize == maxSize_ &&
+        current->minFeeLevel == minFeeLevel)
+    {
+        return;
+    }
+
+    std::atomic_store(&metrics_,
+        std::shared_ptr<MetricsSnapshot const>(
+            std::make_shared<MetricsSnapshot const>(MetricsSnapshot{
+                fees, txCount, maxSize_, minFeeLevel})));
+}
+
 bool
 TxQ::canBeHeld(STTx const& tx, OpenView const& view,
     AccountMap::iterator accountIter,
@@ -611,15 +639,38 @@ TxQ::apply(Application& app, OpenView& view,
         return ripple::apply(app, view, *tx, flags, j);
     }
 
+    // See if the transaction is valid, properly formed,
+    // etc. before doing potentially expensive queue
+    // replace and multi-transaction operations.
+    return apply(app, view, tx,
+        preflight(app, view.rules(), *tx, flags, j), j);
+}
+
+std::pair<STer, bool>
+TxQ::apply(Application& app, OpenView& view,
+    std::shared_ptr<STTx const> const& tx,
+        PreflightResult const& pfresult, beast::Journal j)
+{
+    auto const allowEscalation =
+        (view.rules().enabled(featureFeeEscalation));
+    if (!allowEscalation)
+    {
+        return ripple::apply(app, view, pfresult);
+    }
+
+    // The result is only meaningful under the rules it
+    // was computed with, e.g. an amendment may have
+    // taken effect since.
+    if (pfresult.rules != view.rules())
+    {
+        return apply(app, view, tx, pfresult.flags, j);
+    }
+
+    auto const flags = pfresult.flags;
     auto const account = (*tx)[sfAccount];
     auto const transactionID = tx->getTransactionID();
     auto const tSeq = tx->getSequence();
 
-    // See if the transaction is valid, properly formed,
-    // etc. before doing potentially expensive queue
-    // replace and multi-transaction operations.
-    auto const pfresult = preflight(app, view.rules(),
-        *tx, flags, j);
     if (pfresult.ter != tesSUCCESS)
         return{ pfresult.ter, false };
 
@@ -640,6 +691,7 @@ TxQ::apply(Application& app, OpenView& view,
     boost::optional<FeeMultiSet::iterator> replacedItemDeleteIter;
 
     std::lock_guard<std::mutex> lock(mutex_);
+    MetricsPublisher publisher(*this);
 
     auto const metricsSnapshot = feeMetrics_.getSnapshot();
 
@@ -1143,6 +1195,7 @@ TxQ::processClosedLedger(Application& app,
     }
 
     std::lock_guard<std::mutex> lock(mutex_);
+    MetricsPublisher publisher(*this);
 
     feeMetrics_.update(app, view, timeLeap, setup_);
     auto const& snapshot = feeMetrics_.getSnapshot();
@@ -1232,6 +1285,7 @@ TxQ::accept(Application& app,
     auto ledgerChanged = false;
 
     std::lock_guard<std::mutex> lock(mutex_);
+    MetricsPublisher publisher(*this);
 
     auto const metricSnapshot = feeMetrics_.getSnapshot();
 
@@ -1347,17 +1401,16 @@ TxQ::getMetrics(OpenView const& view, std::uint32_t txCountPadding) const
 
     Metrics result;
 
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    auto const snapshot = feeMetrics_.getSnapshot();
+    // No lock: the queue state comes from the published snapshot.
+    auto const metrics = std::atomic_load(&metrics_);
+    auto const& snapshot = metrics->fees;
 
-    result.txCount = byFee_.size();
-    result.txQMaxSize = maxSize_;
+    result.txCount = metrics->txCount;
+    result.txQMaxSize = metrics->maxSize;
     result.txInLedger = view.txCount();
     result.txPerLedger = snapshot.txnsExpected;
     result.referenceFeeLevel = baseLevel;
-    result.minFeeLevel = isFull() ? byFee_.rbegin()->feeLevel + 1 :
-        baseLevel;
+    result.minFeeLevel = metrics->minFeeLevel;
     result.medFeeLevel = snapshot.escalationMultiplier;
     result.expFeeLevel = FeeMetrics::scaleFeeLevel(snapshot, view,
         txCountPadding);
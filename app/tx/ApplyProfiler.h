@@ -0,0 +1,116 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_TX_APPLYPROFILER_H_INCLUDED
+#define RIPPLE_TX_APPLYPROFILER_H_INCLUDED
+
+#include <ripple/protocol/TxFormats.h>
+#include <ripple/beast/insight/Counter.h>
+#include <ripple/beast/insight/Event.h>
+#include <ripple/json/json_value.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace ripple {
+
+class CollectorManager;
+
+/** Time spent in each step of applying transactions, by type.
+
+    Records a histogram of the duration of preflight, preclaim,
+    doApply, the invariant checks and metadata generation for each
+    transaction type, along with the number of ledger entries each
+    transaction read from and wrote to its base view.
+
+    Every sample is also reported through beast::insight, in the
+    "apply" group, as "<type>.<stage>" events and "<type>.reads" /
+    "<type>.writes" counters.
+
+    Thread safety:
+        All members may be called concurrently.
+*/
+class ApplyProfiler
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    enum Stage
+    {
+        preflight,
+        preclaim,
+        doApply,
+        invariants,
+        metadata,
+
+        stageCount
+    };
+
+    explicit
+    ApplyProfiler (CollectorManager& cm);
+
+    ApplyProfiler (ApplyProfiler const&) = delete;
+    ApplyProfiler& operator= (ApplyProfiler const&) = delete;
+
+    /** Record a stage that started at `start` and ended now. */
+    void
+    add (TxType type, Stage stage, clock_type::time_point start);
+
+    /** Record the ledger entries one transaction touched. */
+    void
+    addAccess (TxType type, std::size_t reads, std::size_t writes);
+
+    /** The histograms of every type seen so far. */
+    Json::Value
+    json () const;
+
+private:
+    // Bucket i counts durations below 2^i microseconds;
+    // the last one counts everything longer.
+    static std::size_t const bucketCount = 22;
+
+    // TxType values are small; larger ones are not recorded.
+    static std::size_t const typeCount = 128;
+
+    struct Histogram
+    {
+        std::array<std::atomic<std::uint64_t>, bucketCount> buckets {};
+        std::atomic<std::uint64_t> count {0};
+        std::atomic<std::uint64_t> total {0};
+        std::atomic<std::uint64_t> max {0};
+        beast::insight::Event event;
+    };
+
+    struct Type
+    {
+        std::array<Histogram, stageCount> stages;
+        std::atomic<std::uint64_t> transactions {0};
+        std::atomic<std::uint64_t> reads {0};
+        std::atomic<std::uint64_t> writes {0};
+        beast::insight::Counter readCounter;
+        beast::insight::Counter writeCounter;
+    };
+
+    std::array<Type, typeCount> types_;
+};
+
+} // ripple
+
+#endif
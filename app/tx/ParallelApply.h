@@ -0,0 +1,113 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_TX_PARALLELAPPLY_H_INCLUDED
+#define RIPPLE_TX_PARALLELAPPLY_H_INCLUDED
+
+#include <ripple/app/misc/CanonicalTXSet.h>
+#include <ripple/ledger/ApplyView.h>
+#include <ripple/ledger/OpenView.h>
+#include <ripple/protocol/STTx.h>
+#include <ripple/beast/utility/Journal.h>
+#include <cstddef>
+#include <functional>
+
+namespace ripple {
+
+class Application;
+
+/** Applies a canonical transaction set using several threads.
+
+    Transactions are taken from the set in canonical order, in batches.
+    Every transaction of a batch is first applied speculatively, in
+    parallel, to its own OpenView layered over the current state. The
+    keys and key ranges each one reads are recorded. The results are then
+    committed in canonical order. A transaction whose reads overlap the
+    writes of an earlier transaction in the same batch is discarded and
+    applied again against the committed state.
+
+    A transaction only commits if it observed exactly the state it
+    would have seen serially. The resulting ledger is therefore
+    identical to the one produced by applying the set one transaction
+    at a time.
+
+    Transaction types that can touch state outside the view (tables,
+    contracts, order book registration) are never speculated. They act
+    as barriers and are applied on the calling thread.
+
+    Speculation runs on the calling thread and on helper jobs from the
+    JobQueue, so constructing one of these is cheap.
+*/
+class ParallelApply
+{
+public:
+    ParallelApply (Application& app,
+        std::size_t threads, beast::Journal j);
+
+    ParallelApply (ParallelApply const&) = delete;
+    ParallelApply& operator= (ParallelApply const&) = delete;
+
+    /** Make one pass over the set, as applyTransactions does.
+
+        Transactions that succeed or fail are removed from the set,
+        those that should be retried are left in it.
+
+        @return The number of transactions that were applied.
+    */
+    int
+    pass (OpenView& view, CanonicalTXSet& txs,
+        bool certainRetry, ApplyFlags flags);
+
+    /** Number of transactions applied speculatively in the last pass. */
+    std::size_t
+    speculated() const
+    {
+        return speculated_;
+    }
+
+    /** Number of speculative results discarded in the last pass. */
+    std::size_t
+    reapplied() const
+    {
+        return reapplied_;
+    }
+
+private:
+    class Recorder;
+    class Committer;
+    struct Speculation;
+
+    static
+    bool
+    canSpeculate (STTx const& tx);
+
+    // Run f(0) ... f(n-1) on this thread and up to threads_ - 1 jobs
+    void
+    parallel (std::size_t n, std::function<void(std::size_t)> const& f);
+
+    Application& app_;
+    beast::Journal j_;
+    std::size_t const threads_;
+    std::size_t speculated_ = 0;
+    std::size_t reapplied_ = 0;
+};
+
+} // ripple
+
+#endif
@@ -27,11 +27,13 @@
 #include <ripple/beast/utility/Journal.h>
 #include <memory>
 #include <utility>
+#include <vector>
 
 namespace ripple {
 
 class Application;
 class HashRouter;
+struct PreflightResult;
 
 /** Describes the pre-processing validity of a transaction.
 
@@ -65,6 +67,20 @@ checkValidity(HashRouter& router,
     STTx const& tx, Rules const& rules,
         Config const& config);
 
+/** Checks the signatures of several transactions at once.
+
+    Signatures that are already known good or bad are skipped.
+    The results are cached in the same way as `checkValidity`
+    caches them, so a later call to `checkValidity` for any of
+    these transactions only has to do the local checks.
+
+    @see checkValidity, STTx::checkSign
+*/
+void
+checkSignatures(HashRouter& router,
+    std::vector<std::shared_ptr<STTx const>> const& txs,
+        Rules const& rules);
+
 
 /** Sets the validity of a given transaction in the cache.
 
@@ -125,6 +141,16 @@ apply (Application& app, OpenView& view,
     STTx const& tx, ApplyFlags flags,
         beast::Journal journal);
 
+/** Apply a transaction that has already been through `preflight`.
+
+    Same as the overload above, but reuses a `preflight` result
+    computed earlier, possibly on another thread. If the rules
+    have changed since, `preclaim` runs `preflight` again.
+*/
+std::pair<STer, bool>
+apply (Application& app, OpenView& view,
+    PreflightResult const& pfresult);
+
 
 /** Enum class for return value from `applyTransaction`
 
@@ -22,6 +22,9 @@
 
 #include <ripple/ledger/ApplyViewImpl.h>
 #include <ripple/beast/utility/Journal.h>
+#include <memory>
+#include <utility>
+#include <vector>
 
 namespace ripple {
 
@@ -170,6 +173,11 @@ struct TxConsequences
     The transaction is checked against all possible
     validity constraints that do not require a ledger.
 
+    The result depends only on the arguments, so it is
+    cached by transaction ID, flags and rules. Repeated
+    checks of the same transaction, e.g. on every retry
+    pass, do not redo the work.
+
     @param app The current running `Application`.
     @param rules The `Rules` in effect at the time of the check.
     @param tx The transaction to be checked.
@@ -186,6 +194,26 @@ preflight(Application& app, Rules const& rules,
     STTx const& tx, ApplyFlags flags,
         beast::Journal j);
 
+/** Gate several transactions based on static information.
+
+    Equivalent to calling `preflight` on each transaction,
+    but large batches are spread over the job queue, with
+    the calling thread taking part. No ledger is involved,
+    so the caller does not need to hold any lock.
+
+    @param app The current running `Application`.
+    @param rules The `Rules` in effect at the time of the check.
+    @param txs The transactions, each with its `ApplyFlags`.
+        They must outlive the returned results.
+    @param j A journal.
+
+    @return One `PreflightResult` per transaction, in order.
+*/
+std::vector<PreflightResult>
+preflightBatch(Application& app, Rules const& rules,
+    std::vector<std::pair<std::shared_ptr<STTx const>,
+        ApplyFlags>> const& txs, beast::Journal j);
+
 /** Gate a transaction based on static ledger information.
 
     The transaction is checked against all possible
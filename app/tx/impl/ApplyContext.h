@@ -87,6 +87,10 @@ public:
     std::size_t
     size ();
 
+    /** Get the number of entries read from the base. */
+    std::size_t
+    reads ();
+
     /** Visit unapplied changes. */
     void
     visit (std::function <void (
@@ -0,0 +1,160 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/tx/ApplyProfiler.h>
+#include <ripple/app/main/CollectorManager.h>
+#include <string>
+
+namespace ripple {
+
+static char const* const stageNames[ApplyProfiler::stageCount] =
+{
+    "preflight",
+    "preclaim",
+    "doApply",
+    "invariants",
+    "metadata"
+};
+
+static
+std::string
+typeName (std::size_t type)
+{
+    if (auto const item = TxFormats::getInstance().findByType (
+            static_cast<TxType> (type)))
+        return item->getName ();
+    return std::to_string (type);
+}
+
+ApplyProfiler::ApplyProfiler (CollectorManager& cm)
+{
+    auto const& group = cm.group ("apply");
+    for (std::size_t t = 0; t < typeCount; ++t)
+    {
+        // Only the known types get insight metrics
+        if (! TxFormats::getInstance().findByType (static_cast<TxType> (t)))
+            continue;
+
+        auto const name = typeName (t);
+        auto& type = types_[t];
+        for (std::size_t s = 0; s < stageCount; ++s)
+            type.stages[s].event = group->make_event (
+                name + "." + stageNames[s]);
+        type.readCounter = group->make_counter (name + ".reads");
+        type.writeCounter = group->make_counter (name + ".writes");
+    }
+}
+
+void
+ApplyProfiler::add (TxType txType, Stage stage,
+    clock_type::time_point start)
+{
+    auto const elapsed = std::chrono::duration_cast<
+        std::chrono::microseconds> (clock_type::now() - start);
+
+    auto const t = static_cast<std::size_t> (txType);
+    if (t >= typeCount)
+        return;
+
+    auto const us = static_cast<std::uint64_t> (elapsed.count());
+    std::size_t bucket = 0;
+    while (bucket + 1 < bucketCount && (std::uint64_t (1) << bucket) <= us)
+        ++bucket;
+
+    auto& h = types_[t].stages[stage];
+    h.buckets[bucket].fetch_add (1, std::memory_order_relaxed);
+    h.count.fetch_add (1, std::memory_order_relaxed);
+    h.total.fetch_add (us, std::memory_order_relaxed);
+
+    auto max = h.max.load (std::memory_order_relaxed);
+    while (us > max && ! h.max.compare_exchange_weak (max, us,
+        std::memory_order_relaxed))
+        ;
+
+    h.event.notify (elapsed);
+}
+
+void
+ApplyProfiler::addAccess (TxType txType,
+    std::size_t reads, std::size_t writes)
+{
+    auto const t = static_cast<std::size_t> (txType);
+    if (t >= typeCount)
+        return;
+
+    auto& type = types_[t];
+    type.transactions.fetch_add (1, std::memory_order_relaxed);
+    type.reads.fetch_add (reads, std::memory_order_relaxed);
+    type.writes.fetch_add (writes, std::memory_order_relaxed);
+    type.readCounter.increment (reads);
+    type.writeCounter.increment (writes);
+}
+
+Json::Value
+ApplyProfiler::json () const
+{
+    Json::Value ret = Json::objectValue;
+
+    for (std::size_t t = 0; t < typeCount; ++t)
+    {
+        auto const& type = types_[t];
+        auto const transactions = type.transactions.load ();
+
+        bool seen = transactions != 0;
+        for (auto const& h : type.stages)
+            seen = seen || h.count.load () != 0;
+        if (! seen)
+            continue;
+
+        Json::Value& jt = ret[typeName (t)] = Json::objectValue;
+        jt["transactions"] = std::to_string (transactions);
+        jt["reads"] = std::to_string (type.reads.load ());
+        jt["writes"] = std::to_string (type.writes.load ());
+
+        for (std::size_t s = 0; s < stageCount; ++s)
+        {
+            auto const& h = type.stages[s];
+            auto const count = h.count.load ();
+            if (count == 0)
+                continue;
+
+            Json::Value& js = jt[stageNames[s]] = Json::objectValue;
+            js["count"] = std::to_string (count);
+            js["total_us"] = std::to_string (h.total.load ());
+            js["max_us"] = std::to_string (h.max.load ());
+
+            // Counts of samples below 1, 2, 4 ... microseconds,
+            // up to the last non-empty bucket.
+            std::size_t last = 0;
+            for (std::size_t b = 0; b < bucketCount; ++b)
+            {
+                if (h.buckets[b].load () != 0)
+                    last = b;
+            }
+            Json::Value& jh = js["histogram"] = Json::arrayValue;
+            for (std::size_t b = 0; b <= last; ++b)
+                jh.append (std::to_string (h.buckets[b].load ()));
+        }
+    }
+
+    return ret;
+}
+
+} // ripple
@@ -0,0 +1,408 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/tx/ParallelApply.h>
+#include <ripple/app/main/Application.h>
+#include <ripple/app/tx/apply.h>
+#include <ripple/basics/Log.h>
+#include <ripple/core/JobQueue.h>
+#include <ripple/protocol/SField.h>
+#include <ripple/protocol/STObject.h>
+#include <algorithm>
+#include <set>
+
+namespace ripple {
+
+// Forwards reads to the view being built while remembering
+// everything a speculative transaction looked at.
+class ParallelApply::Recorder
+    : public ReadView
+{
+private:
+    ReadView const& base_;
+    mutable std::vector<uint256> keys_;
+    mutable std::vector<std::pair<
+        uint256, boost::optional<uint256>>> ranges_;
+    mutable bool everything_ = false;
+
+public:
+    explicit
+    Recorder (ReadView const& base)
+        : base_ (base)
+    {
+    }
+
+    /** Returns `true` if the reads overlap any of the written keys. */
+    bool
+    conflicts (std::set<uint256> const& written) const
+    {
+        if (written.empty())
+            return false;
+        if (everything_)
+            return true;
+        for (auto const& key : keys_)
+            if (written.count (key))
+                return true;
+        // A successor query depends on every key up to its answer
+        for (auto const& range : ranges_)
+        {
+            auto const iter = written.upper_bound (range.first);
+            if (iter != written.end() &&
+                    (! range.second || *iter <= *range.second))
+                return true;
+        }
+        return false;
+    }
+
+    LedgerInfo const&
+    info() const override
+    {
+        return base_.info();
+    }
+
+    bool
+    open() const override
+    {
+        return base_.open();
+    }
+
+    Fees const&
+    fees() const override
+    {
+        return base_.fees();
+    }
+
+    Rules const&
+    rules() const override
+    {
+        return base_.rules();
+    }
+
+    bool
+    exists (Keylet const& k) const override
+    {
+        keys_.push_back (k.key);
+        return base_.exists (k);
+    }
+
+    boost::optional<key_type>
+    succ (key_type const& key, boost::optional<
+        key_type> const& last = boost::none) const override
+    {
+        auto const next = base_.succ (key, last);
+        ranges_.emplace_back (key, next ? next : last);
+        return next;
+    }
+
+    std::shared_ptr<SLE const>
+    read (Keylet const& k) const override
+    {
+        keys_.push_back (k.key);
+        return base_.read (k);
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesBegin() const override
+    {
+        everything_ = true;
+        return base_.slesBegin();
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesEnd() const override
+    {
+        everything_ = true;
+        return base_.slesEnd();
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesUpperBound (uint256 const& key) const override
+    {
+        everything_ = true;
+        return base_.slesUpperBound (key);
+    }
+
+    std::unique_ptr<txs_type::iter_base>
+    txsBegin() const override
+    {
+        everything_ = true;
+        return base_.txsBegin();
+    }
+
+    std::unique_ptr<txs_type::iter_base>
+    txsEnd() const override
+    {
+        everything_ = true;
+        return base_.txsEnd();
+    }
+
+    bool
+    txExists (key_type const& key) const override
+    {
+        everything_ = true;
+        return base_.txExists (key);
+    }
+
+    tx_type
+    txRead (key_type const& key) const override
+    {
+        everything_ = true;
+        return base_.txRead (key);
+    }
+};
+
+//------------------------------------------------------------------------------
+
+// Folds a transaction's view into the ledger being built, recording
+// the keys it writes. The metadata was built against a view with no
+// earlier transactions, so its TransactionIndex is set to the
+// position the transaction actually takes in the ledger.
+class ParallelApply::Committer
+    : public TxsRawView
+{
+private:
+    OpenView& to_;
+    std::set<uint256>& written_;
+
+public:
+    Committer (OpenView& to, std::set<uint256>& written)
+        : to_ (to)
+        , written_ (written)
+    {
+    }
+
+    void
+    rawErase (std::shared_ptr<SLE> const& sle) override
+    {
+        written_.insert (sle->key());
+        to_.rawErase (sle);
+    }
+
+    void
+    rawInsert (std::shared_ptr<SLE> const& sle) override
+    {
+        written_.insert (sle->key());
+        to_.rawInsert (sle);
+    }
+
+    void
+    rawReplace (std::shared_ptr<SLE> const& sle) override
+    {
+        written_.insert (sle->key());
+        to_.rawReplace (sle);
+    }
+
+    void
+    rawDestroyWFN (WFNAmount const& fee) override
+    {
+        to_.rawDestroyWFN (fee);
+    }
+
+    void
+    rawTxInsert (ReadView::key_type const& key,
+        std::shared_ptr<Serializer const> const& txn,
+            std::shared_ptr<Serializer const> const& metaData) override
+    {
+        if (! metaData)
+        {
+            to_.rawTxInsert (key, txn, metaData);
+            return;
+        }
+
+        SerialIter sit (metaData->slice());
+        STObject meta (sit, sfMetadata);
+        meta.setFieldU32 (sfTransactionIndex,
+            static_cast<std::uint32_t>(to_.txCount()));
+        auto s = std::make_shared<Serializer>();
+        meta.add (*s);
+        to_.rawTxInsert (key, txn, std::move(s));
+    }
+};
+
+//------------------------------------------------------------------------------
+
+struct ParallelApply::Speculation
+{
+    std::unique_ptr<Recorder> reads;
+    std::unique_ptr<OpenView> view;
+    ApplyResult result = ApplyResult::Fail;
+    bool threw = false;
+};
+
+ParallelApply::ParallelApply (Application& app,
+        std::size_t threads, beast::Journal j)
+    : app_ (app)
+    , j_ (j)
+    , threads_ (std::max<std::size_t> (threads, 1))
+{
+}
+
+bool
+ParallelApply::canSpeculate (STTx const& tx)
+{
+    // Only transactors whose every effect goes through the view
+    switch (tx.getTxnType())
+    {
+    case ttPAYMENT:
+    case ttACCOUNT_SET:
+    case ttREGULAR_KEY_SET:
+    case ttTRUST_SET:
+    case ttOFFER_CANCEL:
+    case ttSIGNER_LIST_SET:
+    case ttESCROW_CREATE:
+    case ttESCROW_FINISH:
+    case ttESCROW_CANCEL:
+    case ttPAYCHAN_CREATE:
+    case ttPAYCHAN_FUND:
+    case ttPAYCHAN_CLAIM:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void
+ParallelApply::parallel (std::size_t n,
+    std::function<void(std::size_t)> const& f)
+{
+    app_.getJobQueue().parallelFor (jtBATCH, "parallelApply",
+        n, 1, threads_, [&f](std::size_t first, std::size_t last)
+        {
+            for (auto i = first; i < last; ++i)
+                f (i);
+        });
+}
+
+int
+ParallelApply::pass (OpenView& view, CanonicalTXSet& txs,
+    bool certainRetry, ApplyFlags flags)
+{
+    // Enough work per batch to keep every thread busy, but small
+    // enough that speculation sees recently committed state
+    std::size_t const batchSize = 32 * threads_;
+
+    speculated_ = 0;
+    reapplied_ = 0;
+    int changes = 0;
+    std::set<uint256> written;
+
+    // Apply against the committed state and fold in the result
+    auto const applyOne = [&](STTx const& tx)
+    {
+        OpenView redo (&view);
+        auto const result = applyTransaction (
+            app_, redo, tx, certainRetry, flags, j_);
+        Committer committer (view, written);
+        redo.apply (committer);
+        return result;
+    };
+
+    // Same bookkeeping as the serial pass in applyTransactions
+    auto const settle = [&](CanonicalTXSet::iterator it, ApplyResult result)
+    {
+        switch (result)
+        {
+        case ApplyResult::Success:
+            ++changes;
+            return txs.erase (it);
+        case ApplyResult::Fail:
+            return txs.erase (it);
+        case ApplyResult::Retry:
+            break;
+        }
+        return ++it;
+    };
+
+    auto it = txs.begin();
+    while (it != txs.end())
+    {
+        if (! canSpeculate (*it->second))
+        {
+            // Nothing is speculating, so apply it directly
+            try
+            {
+                it = settle (it, applyTransaction (
+                    app_, view, *it->second, certainRetry, flags, j_));
+            }
+            catch (std::exception const&)
+            {
+                JLOG(j_.warn()) << "Transaction throws";
+                it = txs.erase (it);
+            }
+            continue;
+        }
+
+        std::vector<CanonicalTXSet::iterator> batch;
+        while (it != txs.end() && batch.size() < batchSize &&
+                canSpeculate (*it->second))
+            batch.push_back (it++);
+
+        std::vector<Speculation> specs (batch.size());
+        parallel (batch.size(), [&](std::size_t i)
+        {
+            auto& spec = specs[i];
+            try
+            {
+                spec.reads = std::make_unique<Recorder> (view);
+                spec.view = std::make_unique<OpenView> (spec.reads.get());
+                spec.result = applyTransaction (app_, *spec.view,
+                    *batch[i]->second, certainRetry, flags, j_);
+            }
+            catch (std::exception const&)
+            {
+                spec.threw = true;
+            }
+        });
+        speculated_ += batch.size();
+
+        written.clear();
+        for (std::size_t i = 0; i < batch.size(); ++i)
+        {
+            auto& spec = specs[i];
+            try
+            {
+                ApplyResult result;
+                if (spec.threw || spec.reads->conflicts (written))
+                {
+                    ++reapplied_;
+                    result = applyOne (*batch[i]->second);
+                }
+                else
+                {
+                    Committer committer (view, written);
+                    spec.view->apply (committer);
+                    result = spec.result;
+                }
+                settle (batch[i], result);
+            }
+            catch (std::exception const&)
+            {
+                JLOG(j_.warn()) << "Transaction throws";
+                txs.erase (batch[i]);
+            }
+        }
+    }
+
+    JLOG(j_.debug()) << "Parallel pass: " << speculated_ << " speculated, "
+        << reapplied_ << " reapplied";
+    return changes;
+}
+
+} // ripple
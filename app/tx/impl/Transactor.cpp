@@ -21,6 +21,7 @@
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/LoadFeeTrack.h>
 #include <ripple/app/tx/apply.h>
+#include <ripple/app/tx/ApplyProfiler.h>
 #include <ripple/app/tx/impl/Transactor.h>
 #include <ripple/app/tx/impl/SignerEntries.h>
 #include <ripple/basics/contract.h>
@@ -708,9 +709,16 @@ Transactor::operator()()
     }
 #endif
 
+    auto& profiler = ctx_.app.getApplyProfiler();
+    auto const txType = ctx_.tx.getTxnType();
+
     auto terResult = STer(ctx_.preclaimResult);
     if (terResult == tesSUCCESS)
+    {
+        auto const start = ApplyProfiler::clock_type::now();
         terResult = apply();
+        profiler.add(txType, ApplyProfiler::doApply, start);
+    }
 
     // No transaction can return temUNKNOWN from apply,
     // and it can't be passed in from a preclaim.
@@ -772,6 +780,8 @@ Transactor::operator()()
 
     if (didApply)
     {
+        auto const start = ApplyProfiler::clock_type::now();
+
         // Check invariants
         // if `tecINVARIANT_FAILED` not returned, we can proceed to apply the tx
         terResult.ter = ctx_.checkInvariants(terResult);
@@ -784,6 +794,8 @@ Transactor::operator()()
             terResult.ter = ctx_.checkInvariants(terResult);
             didApply = isTecClaim(terResult);
         }
+
+        profiler.add(txType, ApplyProfiler::invariants, start);
     }
 
     if (didApply)
@@ -807,9 +819,13 @@ Transactor::operator()()
                 ctx_.destroyWFN (fee);
         }
 
+        profiler.addAccess(txType, ctx_.reads(), ctx_.size());
+
+        auto const start = ApplyProfiler::clock_type::now();
         ctx_.apply(terResult);
         // since we called apply(), it is not okay to look
         // at view() past this point.
+        profiler.add(txType, ApplyProfiler::metadata, start);
     }
     else
     {
@@ -82,6 +82,29 @@ checkValidity(HashRouter& router,
     return {Validity::Valid, ""};
 }
 
+void
+checkSignatures(HashRouter& router,
+    std::vector<std::shared_ptr<STTx const>> const& txs,
+        Rules const& rules)
+{
+    std::vector<STTx const*> unknown;
+    unknown.reserve(txs.size());
+    for (auto const& tx : txs)
+    {
+        auto const flags = router.getFlags(tx->getTransactionID());
+        if (!(flags & (SF_SIGBAD | SF_SIGGOOD)))
+            unknown.push_back(tx.get());
+    }
+
+    auto const results = STTx::checkSign(unknown,
+        rules.enabled(featureMultiSign));
+    for (std::size_t i = 0; i < unknown.size(); ++i)
+    {
+        router.setFlags(unknown[i]->getTransactionID(),
+            results[i].first ? SF_SIGGOOD : SF_SIGBAD);
+    }
+}
+
 void
 forceValidity(HashRouter& router, uint256 const& txid,
     Validity validity)
@@ -114,6 +137,15 @@ apply (Application& app, OpenView& view,
     return doApply(pcresult, app, view);
 }
 
+std::pair<STer, bool>
+apply (Application& app, OpenView& view,
+    PreflightResult const& pfresult)
+{
+    STAmountSO saved(view.info().parentCloseTime);
+    auto pcresult = preclaim(pfresult, app, view);
+    return doApply(pcresult, app, view);
+}
+
 ApplyResult
 applyTransaction (Application& app, OpenView& view,
     STTx const& txn,
@@ -19,6 +19,10 @@
 
 #include <BeastConfig.h>
 #include <ripple/app/tx/applySteps.h>
+#include <ripple/app/main/Application.h>
+#include <ripple/app/tx/ApplyProfiler.h>
+#include <ripple/basics/GenerationalCache.h>
+#include <ripple/core/JobQueue.h>
 #include <ripple/app/tx/impl/ApplyContext.h>
 #include <ripple/app/tx/impl/CancelOffer.h>
 #include <ripple/app/tx/impl/CancelTicket.h>
@@ -36,6 +40,7 @@
 #include <peersafe/app/tx/SqlStatement.h>
 #include <peersafe/app/tx/SqlTransaction.h>
 #include <peersafe/app/tx/SmartContract.h>
+#include <boost/optional.hpp>
 
 namespace ripple {
 
@@ -255,6 +260,57 @@ invoke_apply (ApplyContext& ctx)
     }
 }
 
+namespace detail {
+
+/** Remembers preflight results.
+
+    Preflight depends only on the transaction, the rules and the
+    flags, but a transaction is preflighted again when it is
+    relayed, retried, reapplied from the queue and applied to
+    the consensus ledger. Entries are keyed by transaction ID and
+    flags, and only match under equal rules.
+*/
+class PreflightCache
+{
+public:
+    boost::optional<TER>
+    find (uint256 const& txID, ApplyFlags flags, Rules const& rules)
+    {
+        auto const entry = cache_.find (key_type {txID, flags});
+        if (entry && entry->rules == rules)
+            return entry->ter;
+        return boost::none;
+    }
+
+    void
+    insert (uint256 const& txID, ApplyFlags flags,
+        Rules const& rules, TER ter)
+    {
+        cache_.insert (key_type {txID, flags}, Entry {rules, ter});
+    }
+
+private:
+    using key_type = std::pair<uint256, ApplyFlags>;
+
+    struct Entry
+    {
+        Rules rules;
+        TER ter;
+    };
+
+    // Entries per generation in each shard
+    GenerationalCache<key_type, Entry> cache_ {1024};
+};
+
+PreflightCache&
+preflightCache()
+{
+    static PreflightCache cache;
+    return cache;
+}
+
+} // detail
+
 PreflightResult
 preflight(Application& app, Rules const& rules,
     STTx const& tx, ApplyFlags flags,
@@ -262,9 +318,28 @@ preflight(Application& app, Rules const& rules,
 {
     PreflightContext const pfctx(app, tx,
         rules, flags, j);
+
+    // Transactors with effects outside the ledger are
+    // always checked afresh.
+    bool const cacheable = ! tx.isAjmChainTableType() &&
+        ! STTx::checkAjmchainContractType(tx.getTxnType());
+    auto const txID = tx.getTransactionID();
+    if (cacheable)
+    {
+        if (auto const ter =
+                detail::preflightCache().find(txID, flags, rules))
+            return{ pfctx, *ter };
+    }
+
     try
     {
-        return{ pfctx, invoke_preflight(pfctx) };
+        auto const start = ApplyProfiler::clock_type::now();
+        auto const ter = invoke_preflight(pfctx);
+        app.getApplyProfiler().add(tx.getTxnType(),
+            ApplyProfiler::preflight, start);
+        if (cacheable)
+            detail::preflightCache().insert(txID, flags, rules, ter);
+        return{ pfctx, ter };
     }
     catch (std::exception const& e)
     {
@@ -274,6 +349,31 @@ preflight(Application& app, Rules const& rules,
     }
 }
 
+std::vector<PreflightResult>
+preflightBatch(Application& app, Rules const& rules,
+    std::vector<std::pair<std::shared_ptr<STTx const>,
+        ApplyFlags>> const& txs, beast::Journal j)
+{
+    // Transactions per unit of work handed to a thread
+    std::size_t const chunk = 32;
+
+    std::vector<boost::optional<PreflightResult>> computed(txs.size());
+    app.getJobQueue().parallelFor(jtBATCH, "preflight",
+        txs.size(), chunk, 0,
+        [&](std::size_t first, std::size_t last)
+        {
+            for (auto i = first; i < last; ++i)
+                computed[i].emplace(preflight(app, rules,
+                    *txs[i].first, txs[i].second, j));
+        });
+
+    std::vector<PreflightResult> results;
+    results.reserve(txs.size());
+    for (auto const& result : computed)
+        results.push_back(*result);
+    return results;
+}
+
 PreclaimResult
 preclaim (PreflightResult const& preflightResult,
     Application& app, OpenView const& view)
@@ -297,7 +397,11 @@ preclaim (PreflightResult const& preflightResult,
     {
         if (ctx->preflightResult != tesSUCCESS)
             return { *ctx, ctx->preflightResult, 0 };
-        return{ *ctx, invoke_preclaim(*ctx) };
+        auto const start = ApplyProfiler::clock_type::now();
+        auto result = invoke_preclaim(*ctx);
+        app.getApplyProfiler().add(ctx->tx.getTxnType(),
+            ApplyProfiler::preclaim, start);
+        return{ *ctx, result };
     }
     catch (std::exception const& e)
     {
@@ -0,0 +1,136 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_BASICS_GENERATIONALCACHE_H_INCLUDED
+#define RIPPLE_BASICS_GENERATIONALCACHE_H_INCLUDED
+
+#include <ripple/basics/hardened_hash.h>
+#include <boost/optional.hpp>
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+
+namespace ripple {
+
+/** A bounded, thread-safe map that keeps the entries in use.
+
+    Entries are spread over shards, each with its own lock. Every
+    shard holds two generations: lookups search both and move hits
+    from the older one to the newer one, and when the newer one is
+    full it replaces the older one. Entries that stay in use
+    therefore survive, and each shard holds at most twice the
+    generation size.
+
+    The default hash is seeded per process, because keys usually
+    come from peers and can be chosen to collide.
+*/
+template <
+    class Key,
+    class T,
+    class Hash = hardened_hash <>
+>
+class GenerationalCache
+{
+public:
+    using key_type = Key;
+    using mapped_type = T;
+
+    /** Create a cache.
+
+        @param generationSize The entries per generation in each shard.
+    */
+    explicit
+    GenerationalCache (std::size_t generationSize)
+        : generationSize_ (generationSize)
+    {
+    }
+
+    GenerationalCache (GenerationalCache const&) = delete;
+    GenerationalCache& operator= (GenerationalCache const&) = delete;
+
+    /** Returns a copy of the value for `key`, if present. */
+    boost::optional<T>
+    find (Key const& key)
+    {
+        auto& shard = shardFor (key);
+        std::lock_guard<std::mutex> lock (shard.mutex);
+        auto iter = shard.recent.find (key);
+        if (iter != shard.recent.end())
+            return iter->second;
+        iter = shard.old.find (key);
+        if (iter == shard.old.end())
+            return boost::none;
+        T value = iter->second;
+        insert (shard, key, value);
+        return value;
+    }
+
+    /** Set the value for `key`, replacing any previous value. */
+    void
+    insert (Key const& key, T const& value)
+    {
+        auto& shard = shardFor (key);
+        std::lock_guard<std::mutex> lock (shard.mutex);
+        insert (shard, key, value);
+    }
+
+private:
+    static std::size_t const shardCount = 16;
+
+    using map_type = std::unordered_map<Key, T, Hash>;
+
+    struct Shard
+    {
+        std::mutex mutex;
+        map_type recent;
+        map_type old;
+    };
+
+    Shard&
+    shardFor (Key const& key)
+    {
+        return shards_[hash_ (key) % shardCount];
+    }
+
+    void
+    insert (Shard& shard, Key const& key, T const& value)
+    {
+        auto iter = shard.recent.find (key);
+        if (iter != shard.recent.end())
+        {
+            iter->second = value;
+            return;
+        }
+        if (shard.recent.size() >= generationSize_)
+        {
+            shard.old = std::move (shard.recent);
+            shard.recent.clear();
+        }
+        shard.recent.emplace (key, value);
+    }
+
+    std::size_t const generationSize_;
+    Hash hash_;
+    std::array<Shard, shardCount> shards_;
+};
+
+} // ripple
+
+#endif
@@ -34,6 +34,7 @@ shouldCloseLedger(
         timeSincePrevClose,              // Time since last ledger's close time
     std::chrono::milliseconds openTime,  // Time waiting to close this ledger
     std::chrono::milliseconds idleInterval,
+    ConsensusBacklog const& backlog,
     ConsensusParms const& parms,
     beast::Journal j)
 {
@@ -50,6 +51,12 @@ shouldCloseLedger(
         return true;
     }
 
+    // Peers that validated the last ledger are ready for this one, but
+    // only peers that closed may cut an adaptive open time short
+    if (parms.ledgerADAPTIVE_CLOSE &&
+        openTime < getMinimumOpenTime(backlog, parms))
+        proposersValidated = 0;
+
     if ((proposersClosed + proposersValidated) > (prevProposers / 2))
     {
         // If more than half of the network has closed, we close
@@ -64,9 +71,11 @@ shouldCloseLedger(
     }
 
     // Preserve minimum ledger open time
-    if (openTime < parms.ledgerMIN_CLOSE)
+    if (openTime < getMinimumOpenTime(backlog, parms))
     {
-        JLOG(j.debug()) << "Must wait minimum time before closing";
+        JLOG(j.debug()) << "Must wait minimum time before closing"
+                        << " (backlog " << backlog.pending << "/"
+                        << backlog.capacity << ")";
         return false;
     }
 
@@ -83,6 +92,25 @@ shouldCloseLedger(
     return true;
 }
 
+std::chrono::milliseconds
+getMinimumOpenTime(
+    ConsensusBacklog const& backlog,
+    ConsensusParms const& parms)
+{
+    if (!parms.ledgerADAPTIVE_CLOSE || backlog.capacity == 0)
+        return parms.ledgerMIN_CLOSE;
+
+    // More than we can apply in the usual open time, close early
+    if (backlog.pending >= backlog.capacity)
+        return parms.ledgerMIN_ADAPTIVE_CLOSE;
+
+    // Little to apply, let transactions accumulate
+    if (backlog.pending * 100 < backlog.capacity * parms.ledgerIDLE_BACKLOG_PCT)
+        return parms.ledgerMAX_ADAPTIVE_CLOSE;
+
+    return parms.ledgerMIN_CLOSE;
+}
+
 bool
 checkConsensusReached(
     std::size_t agreeing,
@@ -48,6 +48,7 @@ namespace ripple {
                         close time
     @param openTime     duration this ledger has been open
     @param idleInterval the network's desired idle interval
+    @param backlog      transactions waiting to be closed
     @param parms        Consensus constant parameters
     @param j            journal for logging
 */
@@ -61,9 +62,29 @@ shouldCloseLedger(
     std::chrono::milliseconds timeSincePrevClose,
     std::chrono::milliseconds openTime,
     std::chrono::milliseconds idleInterval,
+    ConsensusBacklog const & backlog,
     ConsensusParms const & parms,
     beast::Journal j);
 
+/** The minimum time a ledger with transactions is held open.
+
+    This is ConsensusParms::ledgerMIN_CLOSE, unless adaptive closes are
+    enabled and the application knows its apply capacity. Then a backlog
+    of at least that capacity shortens the time to ledgerMIN_ADAPTIVE_CLOSE,
+    and a backlog under ledgerIDLE_BACKLOG_PCT of it lengthens the time to
+    ledgerMAX_ADAPTIVE_CLOSE.
+
+    Only these three durations are ever returned, so nodes under similar
+    load make the same choice.
+
+    @param backlog transactions waiting to be closed
+    @param parms   Consensus constant parameters
+*/
+std::chrono::milliseconds
+getMinimumOpenTime(
+    ConsensusBacklog const & backlog,
+    ConsensusParms const & parms);
+
 /** Determine whether the network reached consensus and whether we joined.
 
     @param prevProposers proposers in the last closing (not including us)
@@ -220,6 +241,10 @@ checkConsensus(
       // Whether any transactions are in the open ledger
       bool hasOpenTransactions() const;
 
+      // Transactions waiting to be closed, and how many can be applied
+      // in parms().ledgerMIN_CLOSE
+      ConsensusBacklog openBacklog() const;
+
       // Number of proposers that have validated the given ledger
       std::size_t proposersValidated(Ledger::ID const & prevLedger) const;
 
@@ -1090,6 +1115,7 @@ Consensus<Adaptor>::phaseOpen()
             sinceClose,
             openTime_.read(),
             idleInterval,
+            adaptor_.openBacklog(),
             adaptor_.parms(),
             j_))
     {
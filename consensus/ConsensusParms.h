@@ -88,6 +88,24 @@ struct ConsensusParms
     //! How often we check state or change positions
     std::chrono::milliseconds ledgerGRANULARITY = 1s;
 
+    /** Whether the minimum open time adapts to the open ledger backlog.
+
+        When set, a ledger whose backlog is more than can be applied in
+        ledgerMIN_CLOSE closes after ledgerMIN_ADAPTIVE_CLOSE, and one
+        whose backlog is under ledgerIDLE_BACKLOG_PCT of that stays open
+        for ledgerMAX_ADAPTIVE_CLOSE. Otherwise ledgerMIN_CLOSE applies.
+    */
+    bool ledgerADAPTIVE_CLOSE = false;
+
+    //! Minimum open time of a ledger with a full backlog
+    std::chrono::milliseconds ledgerMIN_ADAPTIVE_CLOSE = 1s;
+
+    //! Minimum open time of a ledger with a light backlog
+    std::chrono::milliseconds ledgerMAX_ADAPTIVE_CLOSE = 4s;
+
+    //! Percentage of the apply capacity below which a backlog is light
+    std::size_t ledgerIDLE_BACKLOG_PCT = 10;
+
     /** The minimum amount of time to consider the previous round
         to have taken.
 
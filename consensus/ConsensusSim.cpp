@@ -0,0 +1,1283 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/consensus/ConsensusSim.h>
+#include <ripple/basics/Log.h>
+#include <ripple/basics/UnorderedContainers.h>
+#include <ripple/basics/chrono.h>
+#include <ripple/beast/clock/manual_clock.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <ripple/consensus/Consensus.h>
+#include <ripple/protocol/JsonFields.h>
+#include <ripple/protocol/digest.h>
+#include <boost/optional.hpp>
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <memory>
+#include <queue>
+#include <random>
+#include <tuple>
+#include <vector>
+
+namespace ripple {
+
+namespace {
+
+using namespace std::chrono;
+using sim_clock = beast::manual_clock<steady_clock>;
+using PeerID = std::uint32_t;
+
+// A transaction is nothing but its identifier
+class SimTx
+{
+public:
+    using ID = std::uint64_t;
+
+    explicit SimTx(ID id) : id_(id)
+    {
+    }
+
+    ID
+    id() const
+    {
+        return id_;
+    }
+
+private:
+    ID id_;
+};
+
+// An immutable set of transactions identified by the hash of their IDs
+class SimTxSet
+{
+public:
+    using ID = uint256;
+    using Tx = SimTx;
+    using Map = std::map<Tx::ID, Tx>;
+
+    class MutableTxSet
+    {
+    public:
+        MutableTxSet(SimTxSet const& s) : txs_(*s.txs_)
+        {
+        }
+
+        bool
+        insert(Tx const& tx)
+        {
+            return txs_.emplace(tx.id(), tx).second;
+        }
+
+        bool
+        erase(Tx::ID const& id)
+        {
+            return txs_.erase(id) != 0;
+        }
+
+    private:
+        friend class SimTxSet;
+        Map txs_;
+    };
+
+    explicit SimTxSet(Map txs)
+        : txs_(std::make_shared<Map const>(std::move(txs)))
+    {
+        using beast::hash_append;
+        sha512_half_hasher h;
+        for (auto const& tx : *txs_)
+            hash_append(h, tx.first);
+        id_ = static_cast<uint256>(h);
+    }
+
+    SimTxSet(MutableTxSet const& m) : SimTxSet(m.txs_)
+    {
+    }
+
+    bool
+    exists(Tx::ID const& id) const
+    {
+        return txs_->count(id) != 0;
+    }
+
+    Tx const*
+    find(Tx::ID const& id) const
+    {
+        auto const it = txs_->find(id);
+        return it == txs_->end() ? nullptr : &it->second;
+    }
+
+    ID const&
+    id() const
+    {
+        return id_;
+    }
+
+    std::map<Tx::ID, bool>
+    compare(SimTxSet const& other) const
+    {
+        std::map<Tx::ID, bool> ret;
+        for (auto const& tx : *txs_)
+            if (!other.exists(tx.first))
+                ret.emplace(tx.first, true);
+        for (auto const& tx : *other.txs_)
+            if (!exists(tx.first))
+                ret.emplace(tx.first, false);
+        return ret;
+    }
+
+    std::size_t
+    size() const
+    {
+        return txs_->size();
+    }
+
+    Map::const_iterator
+    begin() const
+    {
+        return txs_->begin();
+    }
+
+    Map::const_iterator
+    end() const
+    {
+        return txs_->end();
+    }
+
+private:
+    std::shared_ptr<Map const> txs_;
+    ID id_;
+};
+
+// A closed ledger, which records the transactions it applied
+class SimLedger
+{
+public:
+    using ID = uint256;
+
+    SimLedger() : data_(std::make_shared<Data>())
+    {
+    }
+
+    SimLedger(
+        SimLedger const& parent,
+        SimTxSet const& txs,
+        NetClock::time_point closeTime,
+        NetClock::duration closeResolution,
+        bool closeAgree)
+    {
+        auto data = std::make_shared<Data>();
+        data->parentID = parent.id();
+        data->seq = parent.seq() + 1;
+        data->closeTimeResolution = closeResolution;
+        data->closeAgree = closeAgree;
+        data->closeTime = closeTime;
+        data->parentCloseTime = parent.closeTime();
+        data->txs = txs;
+
+        using beast::hash_append;
+        sha512_half_hasher h;
+        hash_append(h, data->parentID, data->seq, txs.id(),
+            closeTime.time_since_epoch().count(),
+            closeResolution.count(), closeAgree);
+        data->id = static_cast<uint256>(h);
+        data_ = std::move(data);
+    }
+
+    static SimLedger
+    genesis(NetClock::time_point closeTime)
+    {
+        SimLedger ret;
+        auto data = std::make_shared<Data>();
+        data->seq = 1;
+        data->closeTime = closeTime;
+        data->id = sha512Half(std::uint32_t{1});
+        ret.data_ = std::move(data);
+        return ret;
+    }
+
+    ID const&
+    id() const
+    {
+        return data_->id;
+    }
+
+    ID const&
+    parentID() const
+    {
+        return data_->parentID;
+    }
+
+    std::uint32_t
+    seq() const
+    {
+        return data_->seq;
+    }
+
+    NetClock::duration
+    closeTimeResolution() const
+    {
+        return data_->closeTimeResolution;
+    }
+
+    bool
+    closeAgree() const
+    {
+        return data_->closeAgree;
+    }
+
+    NetClock::time_point
+    closeTime() const
+    {
+        return data_->closeTime;
+    }
+
+    NetClock::time_point
+    parentCloseTime() const
+    {
+        return data_->parentCloseTime;
+    }
+
+    SimTxSet const&
+    txs() const
+    {
+        return data_->txs;
+    }
+
+    Json::Value
+    getJson() const
+    {
+        Json::Value ret(Json::objectValue);
+        ret[jss::ledger_hash] = to_string(id());
+        ret[jss::parent_hash] = to_string(parentID());
+        ret[jss::ledger_index] = seq();
+        ret[jss::close_time] = closeTime().time_since_epoch().count();
+        ret["close_agree"] = closeAgree();
+        ret["transactions"] = static_cast<Json::UInt>(txs().size());
+        return ret;
+    }
+
+private:
+    struct Data
+    {
+        ID id;
+        ID parentID;
+        std::uint32_t seq = 0;
+        NetClock::duration closeTimeResolution = ledgerDefaultTimeResolution;
+        bool closeAgree = true;
+        NetClock::time_point closeTime;
+        NetClock::time_point parentCloseTime;
+        SimTxSet txs{SimTxSet::Map{}};
+    };
+
+    std::shared_ptr<Data const> data_;
+};
+
+class SimPeerPosition
+{
+public:
+    using Proposal = ConsensusProposal<PeerID, SimLedger::ID, SimTxSet::ID>;
+
+    explicit SimPeerPosition(Proposal const& proposal) : proposal_(proposal)
+    {
+    }
+
+    Proposal const&
+    proposal() const
+    {
+        return proposal_;
+    }
+
+    Json::Value
+    getJson() const
+    {
+        return proposal_.getJson();
+    }
+
+private:
+    Proposal proposal_;
+};
+
+class Sim;
+
+// The consensus adaptor of one simulated peer
+class SimPeer
+{
+public:
+    using Ledger_t = SimLedger;
+    using NodeID_t = PeerID;
+    using TxSet_t = SimTxSet;
+    using PeerPosition_t = SimPeerPosition;
+    using Result = ConsensusResult<SimPeer>;
+
+    SimPeer(Sim& sim, PeerID id, milliseconds skew);
+
+    //--------------------------------------------------------------------------
+    // Consensus adaptor
+
+    boost::optional<SimLedger>
+    acquireLedger(SimLedger::ID const& id);
+
+    boost::optional<SimTxSet>
+    acquireTxSet(SimTxSet::ID const& id);
+
+    bool
+    hasOpenTransactions() const
+    {
+        return !pool_.empty();
+    }
+
+    ConsensusBacklog
+    openBacklog() const;
+
+    std::size_t
+    proposersValidated(SimLedger::ID const& id) const;
+
+    std::size_t
+    proposersFinished(SimLedger::ID const& id) const;
+
+    SimLedger::ID
+    getPrevLedger(
+        SimLedger::ID ledgerID,
+        SimLedger const& ledger,
+        ConsensusMode mode);
+
+    void
+    onModeChange(ConsensusMode before, ConsensusMode after);
+
+    Result
+    onClose(
+        SimLedger const& ledger,
+        NetClock::time_point const& closeTime,
+        ConsensusMode mode);
+
+    void
+    onAccept(
+        Result const& result,
+        SimLedger const& prevLedger,
+        NetClock::duration const& closeResolution,
+        ConsensusCloseTimes const& rawCloseTimes,
+        ConsensusMode const& mode,
+        Json::Value&& consensusJson);
+
+    void
+    onForceAccept(
+        Result const& result,
+        SimLedger const& prevLedger,
+        NetClock::duration const& closeResolution,
+        ConsensusCloseTimes const& rawCloseTimes,
+        ConsensusMode const& mode,
+        Json::Value&& consensusJson)
+    {
+        onAccept(result, prevLedger, closeResolution,
+            rawCloseTimes, mode, std::move(consensusJson));
+    }
+
+    void
+    propose(SimPeerPosition::Proposal const& proposal);
+
+    // Every peer is linked to every other, so a proposal it received
+    // has already reached everyone its sender could reach.
+    void
+    relay(SimPeerPosition const&)
+    {
+    }
+
+    void
+    relay(SimTx const& tx);
+
+    void
+    relay(SimTxSet const& set);
+
+    ConsensusParms const&
+    parms() const;
+
+    //--------------------------------------------------------------------------
+    // Network
+
+    NetClock::time_point
+    now() const;
+
+    void
+    receive(SimTx const& tx);
+
+    // Returns true if the set was not known yet
+    bool
+    receive(SimTxSet const& set);
+
+    void
+    receive(SimLedger const& ledger);
+
+    void
+    receiveValidation(PeerID from, SimLedger const& ledger);
+
+    // Returns false if the item is already being fetched
+    bool
+    startFetch(uint256 const& id)
+    {
+        return fetching_.insert(id).second;
+    }
+
+    void
+    endFetch(uint256 const& id)
+    {
+        fetching_.erase(id);
+    }
+
+    bool
+    hasTxSet(SimTxSet::ID const& id) const
+    {
+        return sets_.count(id) != 0;
+    }
+
+    bool
+    hasLedger(SimLedger::ID const& id) const
+    {
+        return ledgers_.count(id) != 0;
+    }
+
+    // Our own ledger is built: build on it and validate it
+    void
+    accept(SimLedger const& ledger);
+
+private:
+    // Drop the transactions of a ledger and its ancestors from the pool
+    void
+    adopt(SimLedger const& ledger);
+
+    Sim& sim_;
+    PeerID const id_;
+    milliseconds const skew_;
+
+    // Transactions heard of that are not in a ledger we built on
+    SimTxSet::Map pool_;
+    hash_set<SimTx::ID> seen_;
+
+    hash_map<SimTxSet::ID, SimTxSet> sets_;
+    hash_map<SimLedger::ID, SimLedger> ledgers_;
+    hash_set<SimLedger::ID> adopted_;
+    hash_set<uint256> fetching_;
+
+    // The latest ledger each peer validated
+    std::vector<SimLedger> validations_;
+};
+
+struct SimNode
+{
+    SimNode(Sim& sim, PeerID id, milliseconds skew, beast::Journal j);
+
+    SimPeer adaptor;
+    Consensus<SimPeer> consensus;
+};
+
+class Sim
+{
+public:
+    Sim(ConsensusSimSetup const& setup,
+        ConsensusParms const& parms,
+        beast::Journal j);
+
+    Json::Value
+    run();
+
+    sim_clock const&
+    clock() const
+    {
+        return clock_;
+    }
+
+    ConsensusParms const&
+    parms() const
+    {
+        return parms_;
+    }
+
+    ConsensusSimSetup const&
+    setup() const
+    {
+        return setup_;
+    }
+
+    std::size_t
+    size() const
+    {
+        return nodes_.size();
+    }
+
+    SimNode&
+    node(PeerID id)
+    {
+        return *nodes_[id];
+    }
+
+    NetClock::time_point
+    netTime(milliseconds skew) const;
+
+    // Call f after the delay
+    void
+    at(sim_clock::duration delay, std::function<void()> f);
+
+    // Call f after a link's delay, unless the message is lost
+    void
+    send(std::function<void()> f);
+
+    // Send to every peer except the sender
+    void
+    broadcast(PeerID from, std::function<void(SimNode&)> f);
+
+    void
+    fetchTxSet(PeerID to, SimTxSet::ID const& id, int attempts = 3);
+
+    void
+    fetchLedger(PeerID to, SimLedger::ID const& id, int attempts = 3);
+
+    void
+    deliver(SimNode& n, SimTxSet const& set);
+
+    void
+    addTxSet(SimTxSet const& set)
+    {
+        sets_.emplace(set.id(), set);
+    }
+
+    boost::optional<SimLedger>
+    findLedger(SimLedger::ID const& id) const;
+
+    //--------------------------------------------------------------------------
+    // Measurements
+
+    void
+    onClosed(PeerID id, std::size_t backlog);
+
+    void
+    onAccepted(
+        PeerID id,
+        SimLedger const& ledger,
+        milliseconds roundTime,
+        NetClock::duration closeTimeSpread);
+
+    void
+    onWrongLedger()
+    {
+        ++wrongLedger_;
+    }
+
+private:
+    struct Event
+    {
+        sim_clock::time_point when;
+        std::uint64_t seq;
+        std::function<void()> f;
+    };
+
+    struct Later
+    {
+        bool
+        operator()(Event const& a, Event const& b) const
+        {
+            return std::tie(a.when, a.seq) > std::tie(b.when, b.seq);
+        }
+    };
+
+    void
+    tick(PeerID id);
+
+    void
+    submit();
+
+    bool
+    done() const;
+
+    Json::Value
+    report(steady_clock::duration wall) const;
+
+    ConsensusSimSetup const setup_;
+    ConsensusParms const parms_;
+    beast::Journal j_;
+
+    sim_clock clock_;
+    beast::xor_shift_engine rng_;
+    std::priority_queue<Event, std::vector<Event>, Later> events_;
+    std::uint64_t nextEvent_ = 0;
+    std::vector<std::unique_ptr<SimNode>> nodes_;
+
+    // Everything any peer ever built, to serve fetches from
+    hash_map<SimTxSet::ID, SimTxSet> sets_;
+    hash_map<SimLedger::ID, SimLedger> ledgers_;
+
+    SimTx::ID nextTx_ = 0;
+    hash_map<SimTx::ID, sim_clock::time_point> submitted_;
+
+    std::uint32_t genesisSeq_ = 1;
+    std::vector<std::uint32_t> lastSeq_;
+    std::map<std::uint32_t, hash_set<SimLedger::ID>> ids_;
+    sim_clock::time_point finished_;
+
+    std::size_t messages_ = 0;
+    std::size_t lost_ = 0;
+    std::size_t wrongLedger_ = 0;
+    std::size_t accepts_ = 0;
+    std::size_t agreed_ = 0;
+    milliseconds roundTime_{0};
+    milliseconds maxRoundTime_{0};
+    NetClock::duration closeTimeSpread_{0};
+    std::size_t closes_ = 0;
+    std::size_t backlog_ = 0;
+    std::size_t maxBacklog_ = 0;
+    std::size_t transactions_ = 0;
+    std::size_t maxTxSet_ = 0;
+    std::size_t latencies_ = 0;
+    sim_clock::duration latency_{0};
+};
+
+//------------------------------------------------------------------------------
+
+SimPeer::SimPeer(Sim& sim, PeerID id, milliseconds skew)
+    : sim_(sim), id_(id), skew_(skew), validations_(sim.setup().peers)
+{
+}
+
+boost::optional<SimLedger>
+SimPeer::acquireLedger(SimLedger::ID const& id)
+{
+    auto const it = ledgers_.find(id);
+    if (it == ledgers_.end())
+    {
+        sim_.fetchLedger(id_, id);
+        return boost::none;
+    }
+
+    adopt(it->second);
+    return it->second;
+}
+
+boost::optional<SimTxSet>
+SimPeer::acquireTxSet(SimTxSet::ID const& id)
+{
+    auto const it = sets_.find(id);
+    if (it == sets_.end())
+    {
+        sim_.fetchTxSet(id_, id);
+        return boost::none;
+    }
+    return it->second;
+}
+
+ConsensusBacklog
+SimPeer::openBacklog() const
+{
+    ConsensusBacklog backlog;
+    if (!parms().ledgerADAPTIVE_CLOSE)
+        return backlog;
+
+    backlog.pending = pool_.size();
+    if (auto const cost = sim_.setup().applyCost.count())
+        backlog.capacity = static_cast<std::size_t>(
+            duration_cast<microseconds>(parms().ledgerMIN_CLOSE).count() /
+            cost);
+    return backlog;
+}
+
+std::size_t
+SimPeer::proposersValidated(SimLedger::ID const& id) const
+{
+    return std::count_if(validations_.begin(), validations_.end(),
+        [&id](SimLedger const& v) { return v.seq() != 0 && v.id() == id; });
+}
+
+std::size_t
+SimPeer::proposersFinished(SimLedger::ID const& id) const
+{
+    auto const ledger = sim_.findLedger(id);
+    if (!ledger)
+        return 0;
+
+    auto const seq = ledger->seq();
+    return std::count_if(validations_.begin(), validations_.end(),
+        [seq](SimLedger const& v) { return v.seq() > seq; });
+}
+
+SimLedger::ID
+SimPeer::getPrevLedger(
+    SimLedger::ID ledgerID,
+    SimLedger const& ledger,
+    ConsensusMode mode)
+{
+    SimLedger::ID parentID;
+    // Only count our parent if we believe ledger is the right ledger
+    if (mode != ConsensusMode::wrongLedger)
+        parentID = ledger.parentID();
+
+    // Allow up to one ledger slip in either direction
+    hash_map<SimLedger::ID, std::size_t> counts;
+    for (auto const& v : validations_)
+    {
+        if (v.seq() == 0)
+            continue;
+        if (v.id() == ledgerID || v.parentID() == ledgerID ||
+            v.id() == parentID)
+            ++counts[ledgerID];
+        else if (v.seq() >= ledger.seq())
+            ++counts[v.id()];
+    }
+
+    SimLedger::ID netLgr = ledgerID;
+    std::size_t netLgrCount = 0;
+    for (auto const& it : counts)
+    {
+        // Switch to ledger supported by more peers
+        // Or stick with ours on a tie
+        if ((it.second > netLgrCount) ||
+            ((it.second == netLgrCount) && (it.first == ledgerID)))
+        {
+            netLgr = it.first;
+            netLgrCount = it.second;
+        }
+    }
+    return netLgr;
+}
+
+void
+SimPeer::onModeChange(ConsensusMode before, ConsensusMode after)
+{
+    if (after == ConsensusMode::wrongLedger && before != after)
+        sim_.onWrongLedger();
+}
+
+SimPeer::Result
+SimPeer::onClose(
+    SimLedger const& ledger,
+    NetClock::time_point const& closeTime,
+    ConsensusMode mode)
+{
+    sim_.onClosed(id_, pool_.size());
+
+    SimTxSet set{pool_};
+    sets_.emplace(set.id(), set);
+    sim_.addTxSet(set);
+
+    auto const position = set.id();
+    return Result{
+        std::move(set),
+        SimPeerPosition::Proposal{
+            ledger.id(),
+            SimPeerPosition::Proposal::seqJoin,
+            position,
+            closeTime,
+            now(),
+            id_}};
+}
+
+void
+SimPeer::onAccept(
+    Result const& result,
+    SimLedger const& prevLedger,
+    NetClock::duration const& closeResolution,
+    ConsensusCloseTimes const& rawCloseTimes,
+    ConsensusMode const& mode,
+    Json::Value&& consensusJson)
+{
+    bool closeTimeCorrect = true;
+    auto closeTime = result.position.closeTime();
+    if (closeTime == NetClock::time_point{})
+    {
+        // We agreed to disagree on the close time
+        closeTime = prevLedger.closeTime() + 1s;
+        closeTimeCorrect = false;
+    }
+    else
+    {
+        closeTime = effCloseTime(
+            closeTime, closeResolution, prevLedger.closeTime());
+    }
+
+    SimLedger const ledger{prevLedger, result.set, closeTime,
+        closeResolution, closeTimeCorrect};
+
+    // How far apart the peers' proposed close times were
+    auto first = rawCloseTimes.self;
+    auto last = rawCloseTimes.self;
+    if (!rawCloseTimes.peers.empty())
+    {
+        first = std::min(first, rawCloseTimes.peers.begin()->first);
+        last = std::max(last, rawCloseTimes.peers.rbegin()->first);
+    }
+    auto const spread = last - first;
+    auto const roundTime = result.roundTime.read();
+
+    // Applying the agreed set takes time in proportion to its size
+    auto& sim = sim_;
+    auto const id = id_;
+    sim_.at(sim_.setup().applyCost * result.set.size(),
+        [&sim, id, ledger, roundTime, spread]()
+        {
+            auto& n = sim.node(id);
+            n.adaptor.accept(ledger);
+            sim.onAccepted(id, ledger, roundTime, spread);
+            n.consensus.startRound(
+                n.adaptor.now(), ledger.id(), ledger, true);
+        });
+}
+
+void
+SimPeer::propose(SimPeerPosition::Proposal const& proposal)
+{
+    SimPeerPosition const pos{proposal};
+    sim_.broadcast(id_,
+        [pos](SimNode& n)
+        {
+            n.consensus.peerProposal(n.adaptor.now(), pos);
+        });
+}
+
+void
+SimPeer::relay(SimTx const& tx)
+{
+    sim_.broadcast(id_,
+        [tx](SimNode& n)
+        {
+            n.adaptor.receive(tx);
+        });
+}
+
+void
+SimPeer::relay(SimTxSet const& set)
+{
+    sim_.addTxSet(set);
+    auto& sim = sim_;
+    sim_.broadcast(id_,
+        [&sim, set](SimNode& n)
+        {
+            sim.deliver(n, set);
+        });
+}
+
+ConsensusParms const&
+SimPeer::parms() const
+{
+    return sim_.parms();
+}
+
+NetClock::time_point
+SimPeer::now() const
+{
+    return sim_.netTime(skew_);
+}
+
+void
+SimPeer::receive(SimTx const& tx)
+{
+    if (seen_.insert(tx.id()).second)
+        pool_.emplace(tx.id(), tx);
+}
+
+bool
+SimPeer::receive(SimTxSet const& set)
+{
+    fetching_.erase(set.id());
+    return sets_.emplace(set.id(), set).second;
+}
+
+void
+SimPeer::receive(SimLedger const& ledger)
+{
+    fetching_.erase(ledger.id());
+    ledgers_.emplace(ledger.id(), ledger);
+}
+
+void
+SimPeer::receiveValidation(PeerID from, SimLedger const& ledger)
+{
+    if (ledger.seq() > validations_[from].seq())
+        validations_[from] = ledger;
+}
+
+void
+SimPeer::accept(SimLedger const& ledger)
+{
+    ledgers_.emplace(ledger.id(), ledger);
+    adopt(ledger);
+    validations_[id_] = ledger;
+
+    auto const id = id_;
+    sim_.broadcast(id_,
+        [id, ledger](SimNode& n)
+        {
+            n.adaptor.receiveValidation(id, ledger);
+        });
+}
+
+void
+SimPeer::adopt(SimLedger const& ledger)
+{
+    boost::optional<SimLedger> l = ledger;
+    while (l && adopted_.insert(l->id()).second)
+    {
+        for (auto const& tx : l->txs())
+        {
+            seen_.insert(tx.first);
+            pool_.erase(tx.first);
+        }
+        l = sim_.findLedger(l->parentID());
+    }
+}
+
+SimNode::SimNode(Sim& sim, PeerID id, milliseconds skew, beast::Journal j)
+    : adaptor(sim, id, skew), consensus(sim.clock(), adaptor, j)
+{
+}
+
+//------------------------------------------------------------------------------
+
+Sim::Sim(
+    ConsensusSimSetup const& setup,
+    ConsensusParms const& parms,
+    beast::Journal j)
+    : setup_(setup)
+    , parms_(parms)
+    , j_(j)
+    , rng_(setup.seed)
+    , lastSeq_(setup.peers, genesisSeq_)
+{
+    auto const skew = setup_.skew.count();
+    std::uniform_int_distribution<std::int64_t> skews(-skew, skew);
+    for (PeerID id = 0; id < setup_.peers; ++id)
+        nodes_.push_back(std::make_unique<SimNode>(
+            *this, id, milliseconds(skews(rng_)), j_));
+}
+
+NetClock::time_point
+Sim::netTime(milliseconds skew) const
+{
+    // Far enough past the network epoch that no skew goes before it
+    auto const since = hours(24 * 365 * 20) +
+        duration_cast<milliseconds>(clock_.now().time_since_epoch()) + skew;
+    return NetClock::time_point{duration_cast<NetClock::duration>(since)};
+}
+
+void
+Sim::at(sim_clock::duration delay, std::function<void()> f)
+{
+    events_.push(Event{clock_.now() + delay, nextEvent_++, std::move(f)});
+}
+
+void
+Sim::send(std::function<void()> f)
+{
+    ++messages_;
+    if (setup_.lossPct != 0 &&
+        std::uniform_int_distribution<std::size_t>(0, 99)(rng_) <
+            setup_.lossPct)
+    {
+        ++lost_;
+        return;
+    }
+
+    auto const jitter = duration_cast<microseconds>(setup_.jitter).count();
+    at(setup_.latency + microseconds(
+            std::uniform_int_distribution<std::int64_t>(0, jitter)(rng_)),
+        std::move(f));
+}
+
+void
+Sim::broadcast(PeerID from, std::function<void(SimNode&)> f)
+{
+    for (PeerID to = 0; to < nodes_.size(); ++to)
+    {
+        if (to != from)
+            send([this, to, f]() { f(node(to)); });
+    }
+}
+
+void
+Sim::fetchTxSet(PeerID to, SimTxSet::ID const& id, int attempts)
+{
+    if (!node(to).adaptor.startFetch(id))
+        return;
+
+    // A request and its reply, either of which may be lost
+    send([this, to, id]()
+    {
+        send([this, to, id]()
+        {
+            auto const it = sets_.find(id);
+            if (it != sets_.end())
+                deliver(node(to), it->second);
+        });
+    });
+
+    // Ask again if nothing came back
+    at(parms_.ledgerGRANULARITY, [this, to, id, attempts]()
+    {
+        auto& n = node(to);
+        n.adaptor.endFetch(id);
+        if (!n.adaptor.hasTxSet(id) && attempts > 1)
+            fetchTxSet(to, id, attempts - 1);
+    });
+}
+
+void
+Sim::fetchLedger(PeerID to, SimLedger::ID const& id, int attempts)
+{
+    if (!node(to).adaptor.startFetch(id))
+        return;
+
+    send([this, to, id]()
+    {
+        send([this, to, id]()
+        {
+            auto const it = ledgers_.find(id);
+            if (it != ledgers_.end())
+                node(to).adaptor.receive(it->second);
+        });
+    });
+
+    at(parms_.ledgerGRANULARITY, [this, to, id, attempts]()
+    {
+        auto& n = node(to);
+        n.adaptor.endFetch(id);
+        if (!n.adaptor.hasLedger(id) && attempts > 1)
+            fetchLedger(to, id, attempts - 1);
+    });
+}
+
+void
+Sim::deliver(SimNode& n, SimTxSet const& set)
+{
+    if (n.adaptor.receive(set))
+        n.consensus.gotTxSet(n.adaptor.now(), set);
+}
+
+boost::optional<SimLedger>
+Sim::findLedger(SimLedger::ID const& id) const
+{
+    auto const it = ledgers_.find(id);
+    if (it == ledgers_.end())
+        return boost::none;
+    return it->second;
+}
+
+void
+Sim::onClosed(PeerID id, std::size_t backlog)
+{
+    if (id != 0)
+        return;
+    ++closes_;
+    backlog_ += backlog;
+    maxBacklog_ = std::max(maxBacklog_, backlog);
+}
+
+void
+Sim::onAccepted(
+    PeerID id,
+    SimLedger const& ledger,
+    milliseconds roundTime,
+    NetClock::duration closeTimeSpread)
+{
+    ledgers_.emplace(ledger.id(), ledger);
+    ids_[ledger.seq()].insert(ledger.id());
+    lastSeq_[id] = std::max(lastSeq_[id], ledger.seq());
+
+    ++accepts_;
+    if (ledger.closeAgree())
+        ++agreed_;
+    roundTime_ += roundTime;
+    maxRoundTime_ = std::max(maxRoundTime_, roundTime);
+    closeTimeSpread_ += closeTimeSpread;
+
+    if (id == 0)
+    {
+        transactions_ += ledger.txs().size();
+        maxTxSet_ = std::max(maxTxSet_, ledger.txs().size());
+        for (auto const& tx : ledger.txs())
+        {
+            auto const it = submitted_.find(tx.first);
+            if (it == submitted_.end())
+                continue;
+            latency_ += clock_.now() - it->second;
+            ++latencies_;
+            submitted_.erase(it);
+        }
+    }
+
+    if (done() && finished_ == sim_clock::time_point{})
+        finished_ = clock_.now();
+
+    JLOG(j_.debug()) << "Peer " << id << " accepted " << ledger.seq() <<
+        " " << ledger.id() << " with " << ledger.txs().size() <<
+        " transactions in " << roundTime.count() << "ms";
+}
+
+void
+Sim::tick(PeerID id)
+{
+    auto& n = node(id);
+    n.consensus.timerEntry(n.adaptor.now());
+    at(parms_.ledgerGRANULARITY, [this, id]() { tick(id); });
+}
+
+void
+Sim::submit()
+{
+    auto const origin = static_cast<PeerID>(
+        std::uniform_int_distribution<std::size_t>(
+            0, nodes_.size() - 1)(rng_));
+
+    SimTx const tx{++nextTx_};
+    submitted_.emplace(tx.id(), clock_.now());
+    node(origin).adaptor.receive(tx);
+    broadcast(origin, [tx](SimNode& n) { n.adaptor.receive(tx); });
+
+    at(duration_cast<sim_clock::duration>(seconds(1)) / setup_.txRate,
+        [this]() { submit(); });
+}
+
+bool
+Sim::done() const
+{
+    return *std::min_element(lastSeq_.begin(), lastSeq_.end()) >=
+        genesisSeq_ + setup_.ledgers;
+}
+
+Json::Value
+Sim::run()
+{
+    auto const start = steady_clock::now();
+    auto const genesis = SimLedger::genesis(netTime(0ms));
+    ledgers_.emplace(genesis.id(), genesis);
+    genesisSeq_ = genesis.seq();
+
+    // Peers start together but their timers are not in step
+    auto const granularity = duration_cast<microseconds>(
+        parms_.ledgerGRANULARITY).count();
+    std::uniform_int_distribution<std::int64_t> offsets(0, granularity - 1);
+    for (PeerID id = 0; id < nodes_.size(); ++id)
+    {
+        auto& n = node(id);
+        n.adaptor.receive(genesis);
+        n.consensus.startRound(n.adaptor.now(), genesis.id(), genesis, true);
+        at(microseconds(offsets(rng_)), [this, id]() { tick(id); });
+    }
+
+    if (setup_.txRate != 0)
+        at(0s, [this]() { submit(); });
+
+    // A network that makes no progress for this long is stuck
+    auto const limit = clock_.now() +
+        minutes(std::max<int>(static_cast<int>(setup_.ledgers), 1));
+    while (!events_.empty() && !done())
+    {
+        auto e = events_.top();
+        if (e.when > limit)
+            break;
+        events_.pop();
+        clock_.set(e.when);
+        e.f();
+    }
+    if (finished_ == sim_clock::time_point{})
+        finished_ = clock_.now();
+
+    return report(steady_clock::now() - start);
+}
+
+Json::Value
+Sim::report(steady_clock::duration wall) const
+{
+    Json::Value ret(Json::objectValue);
+    ret["peers"] = static_cast<Json::UInt>(nodes_.size());
+    ret["tx_rate"] = static_cast<Json::UInt>(setup_.txRate);
+    ret["latency_ms"] = static_cast<Json::UInt>(setup_.latency.count());
+    ret["loss_pct"] = static_cast<Json::UInt>(setup_.lossPct);
+    ret["adaptive_close"] = parms_.ledgerADAPTIVE_CLOSE;
+
+    auto const ledgers =
+        *std::min_element(lastSeq_.begin(), lastSeq_.end()) - genesisSeq_;
+    auto const elapsed = duration_cast<milliseconds>(
+        finished_.time_since_epoch());
+    auto const secs = elapsed.count() / 1000.0;
+    ret["ledgers"] = ledgers;
+    ret["elapsed_ms"] = static_cast<Json::UInt>(elapsed.count());
+    ret["wall_ms"] = static_cast<Json::UInt>(
+        duration_cast<milliseconds>(wall).count());
+    if (secs > 0)
+    {
+        ret["ledgers_per_sec"] = ledgers / secs;
+        ret["transactions_per_sec"] = transactions_ / secs;
+    }
+
+    std::size_t forks = 0;
+    for (auto const& seq : ids_)
+        if (seq.second.size() > 1)
+            ++forks;
+    ret["forks"] = static_cast<Json::UInt>(forks);
+    ret["wrong_ledger"] = static_cast<Json::UInt>(wrongLedger_);
+
+    if (accepts_ != 0)
+    {
+        Json::Value& round = ret["round_time_ms"] = Json::objectValue;
+        round["avg"] = static_cast<Json::UInt>(
+            roundTime_.count() / accepts_);
+        round["max"] = static_cast<Json::UInt>(maxRoundTime_.count());
+
+        Json::Value& ct = ret["close_time"] = Json::objectValue;
+        ct["agreement"] = double(agreed_) / accepts_;
+        ct["avg_spread_sec"] =
+            double(closeTimeSpread_.count()) / accepts_;
+    }
+
+    ret["transactions"] = static_cast<Json::UInt>(transactions_);
+    ret["max_tx_set"] = static_cast<Json::UInt>(maxTxSet_);
+    if (latencies_ != 0)
+        ret["tx_latency_ms"] = static_cast<Json::UInt>(
+            duration_cast<milliseconds>(latency_).count() / latencies_);
+    if (closes_ != 0)
+    {
+        Json::Value& backlog = ret["open_backlog"] = Json::objectValue;
+        backlog["avg"] = static_cast<Json::UInt>(backlog_ / closes_);
+        backlog["max"] = static_cast<Json::UInt>(maxBacklog_);
+    }
+
+    ret["messages"] = static_cast<Json::UInt>(messages_);
+    ret["lost"] = static_cast<Json::UInt>(lost_);
+
+    ret[jss::status] = done() ? "success" : "error";
+    return ret;
+}
+
+} // namespace
+
+Json::Value
+simulateConsensus(
+    ConsensusSimSetup const& setup,
+    ConsensusParms const& parms,
+    beast::Journal j)
+{
+    if (setup.peers == 0)
+    {
+        Json::Value ret(Json::objectValue);
+        ret[jss::status] = "error";
+        return ret;
+    }
+
+    Sim sim{setup, parms, j};
+    return sim.run();
+}
+
+} // ripple
@@ -0,0 +1,89 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_CONSENSUS_CONSENSUSSIM_H_INCLUDED
+#define RIPPLE_CONSENSUS_CONSENSUSSIM_H_INCLUDED
+
+#include <ripple/beast/utility/Journal.h>
+#include <ripple/consensus/ConsensusParms.h>
+#include <ripple/json/json_value.h>
+#include <chrono>
+#include <cstdint>
+
+namespace ripple {
+
+/** The network and load of a consensus simulation.
+*/
+struct ConsensusSimSetup
+{
+    //! Number of validators, each trusting all the others
+    std::size_t peers = 5;
+
+    //! Ledgers every peer must close before the simulation stops
+    std::size_t ledgers = 20;
+
+    //! Transactions submitted per second, each at a random peer
+    std::size_t txRate = 100;
+
+    //! One way delay of every link
+    std::chrono::milliseconds latency{50};
+
+    //! Random extra delay of up to this much on every message
+    std::chrono::milliseconds jitter{20};
+
+    //! Percentage of messages that are lost
+    std::size_t lossPct = 0;
+
+    //! Each peer's network time is off by up to this much either way
+    std::chrono::milliseconds skew{0};
+
+    //! Time a peer takes to apply one transaction of an agreed set
+    std::chrono::microseconds applyCost{100};
+
+    //! Seed of the random choices, so that runs can be repeated
+    std::uint64_t seed = 1;
+};
+
+/** Run the consensus algorithm between simulated peers.
+
+    Every peer runs its own Consensus instance against an adaptor that
+    keeps its ledgers, transaction sets and open transactions in memory.
+    Messages between peers go through a full mesh of links with the
+    configured latency and loss, and time is simulated, so a run takes
+    only as long as the computation it does.
+
+    Peers open ledgers with the given parameters, so the effect of a
+    change to ConsensusParms or LedgerTiming, including the adaptive
+    close driven by the open transaction backlog, can be measured
+    before it reaches a validator.
+
+    @return A report with the round times, the close time agreement,
+            the ledgers and transactions per simulated second and the
+            number of forks. The report has "status" set to "success"
+            if every peer closed the requested number of ledgers.
+*/
+Json::Value
+simulateConsensus(
+    ConsensusSimSetup const& setup,
+    ConsensusParms const& parms,
+    beast::Journal j);
+
+} // ripple
+
+#endif
@@ -165,6 +165,20 @@ public:
     }
 };
 
+/** Transactions waiting to be closed into a ledger
+
+    Used to adapt the open time of a ledger to the load on the network.
+*/
+struct ConsensusBacklog
+{
+    //! Transactions in the open ledger or waiting to get into it
+    std::size_t pending = 0;
+
+    //! Transactions that can be applied in ConsensusParms::ledgerMIN_CLOSE,
+    //! or zero if not known
+    std::size_t capacity = 0;
+};
+
 /** Stores the set of initial close times
 
     The initial consensus proposal from each peer has that peer's view of
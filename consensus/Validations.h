@@ -371,104 +371,60 @@ public:
         if (!isCurrent(parms_, t, val.signTime(), val.seenTime()))
             return AddOutcome::stale;
 
-        LedgerID const& id = val.ledgerID();
-
         // This is only seated if a validation became stale
         boost::optional<Validation> maybeStaleValidation;
 
-        AddOutcome result = AddOutcome::current;
-
+        AddOutcome result;
         {
             ScopedLock lock{mutex_};
+            result = addLocked(key, val, maybeStaleValidation);
+        }
 
-            auto const ret = byLedger_[id].emplace(key, val);
-
-            // This validation is a repeat if we already have
-            // one with the same id and signing key.
-            if (!ret.second && ret.first->second.key() == val.key())
-                return AddOutcome::repeat;
+        // Handle the newly stale validation outside the lock
+        if (maybeStaleValidation)
+        {
+            stalePolicy_.onStale(std::move(*maybeStaleValidation));
+        }
 
-            // Attempt to insert
-            auto const ins = current_.emplace(key, val);
+        return result;
+    }
 
-            if (!ins.second)
-            {
-                // Had a previous validation from the node, consider updating
-                Validation& oldVal = ins.first->second.val;
-                LedgerID const previousLedgerID = ins.first->second.prevLedgerID;
+    /** Add a batch of validations
 
-                std::uint32_t const oldSeq{oldVal.seq()};
-                std::uint32_t const newSeq{val.seq()};
+        Equivalent to calling add() for each element in order, but the
+        mutex is only acquired once for the whole batch.
 
-                // Sequence of 0 indicates a missing sequence number
-                if (oldSeq && newSeq && oldSeq == newSeq)
-                {
-                    result = AddOutcome::sameSeq;
+        @param vals The NodeKey and validation of each element
+        @return The outcome for each element, in the same order
+    */
+    std::vector<AddOutcome>
+    add(std::vector<std::pair<NodeKey, Validation>> const& vals)
+    {
+        std::vector<AddOutcome> result(vals.size(), AddOutcome::stale);
 
-                    // If the validation key was revoked, update the
-                    // existing validation in the byLedger_ set
-                    if (val.key() != oldVal.key())
-                    {
-                        auto const mapIt = byLedger_.find(oldVal.ledgerID());
-                        if (mapIt != byLedger_.end())
-                        {
-                            auto& validationMap = mapIt->second;
-                            // If a new validation with the same ID was
-                            // reissued we simply replace.
-                            if(oldVal.ledgerID() == val.ledgerID())
-                            {
-                                auto replaceRes = validationMap.emplace(key, val);
-                                // If it was already there, replace
-                                if(!replaceRes.second)
-                                    replaceRes.first->second = val;
-                            }
-                            else
-                            {
-                                // If the new validation has a different ID,
-                                // we remove the old.
-                                validationMap.erase(key);
-                                // Erase the set if it is now empty
-                                if (validationMap.empty())
-                                    byLedger_.erase(mapIt);
-                            }
-                        }
-                    }
-                }
+        // Validations that became stale, handled outside the lock
+        std::vector<Validation> staleValidations;
 
-                if (val.signTime() > oldVal.signTime() ||
-                    val.key() != oldVal.key())
-                {
-                    // This is either a newer validation or a new signing key
-                    LedgerID const prevID = [&]() {
-                        // In the normal case, the prevID is the ID of the
-                        // ledger we replace
-                        if (oldVal.ledgerID() != val.ledgerID())
-                            return oldVal.ledgerID();
-                        // In the case the key was revoked and a new validation
-                        // for the same ledger ID was sent, the previous ledger
-                        // is still the one the now revoked validation had
-                        return previousLedgerID;
-                    }();
-
-                    // Allow impl to take over oldVal
-                    maybeStaleValidation.emplace(std::move(oldVal));
-                    // Replace old val in the map and set the previous ledger ID
-                    ins.first->second.val = val;
-                    ins.first->second.prevLedgerID = prevID;
-                }
-                else
-                {
-                    // We already have a newer validation from this source
-                    result = AddOutcome::stale;
-                }
+        NetClock::time_point t = stalePolicy_.now();
+        {
+            ScopedLock lock{mutex_};
+            for (std::size_t i = 0; i < vals.size(); ++i)
+            {
+                Validation const& val = vals[i].second;
+                if (!isCurrent(parms_, t, val.signTime(), val.seenTime()))
+                    continue;
+
+                boost::optional<Validation> maybeStaleValidation;
+                result[i] = addLocked(
+                    vals[i].first, val, maybeStaleValidation);
+                if (maybeStaleValidation)
+                    staleValidations.emplace_back(
+                        std::move(*maybeStaleValidation));
             }
         }
 
-        // Handle the newly stale validation outside the lock
-        if (maybeStaleValidation)
-        {
-            stalePolicy_.onStale(std::move(*maybeStaleValidation));
-        }
+        for (auto& stale : staleValidations)
+            stalePolicy_.onStale(std::move(stale));
 
         return result;
     }
@@ -720,6 +676,106 @@ public:
 
         JLOG(j_.debug()) << "Validations flushed";
     }
+
+private:
+    /** Add a validation already known to be current
+
+        @param maybeStaleValidation Seated with the validation from the
+                                    same node this one replaced, if any
+        @note mutex_ must be held by the caller
+    */
+    AddOutcome
+    addLocked(NodeKey const& key, Validation const& val,
+        boost::optional<Validation>& maybeStaleValidation)
+    {
+        LedgerID const& id = val.ledgerID();
+
+        AddOutcome result = AddOutcome::current;
+
+        auto const ret = byLedger_[id].emplace(key, val);
+
+        // This validation is a repeat if we already have
+        // one with the same id and signing key.
+        if (!ret.second && ret.first->second.key() == val.key())
+            return AddOutcome::repeat;
+
+        // Attempt to insert
+        auto const ins = current_.emplace(key, val);
+
+        if (!ins.second)
+        {
+            // Had a previous validation from the node, consider updating
+            Validation& oldVal = ins.first->second.val;
+            LedgerID const previousLedgerID = ins.first->second.prevLedgerID;
+
+            std::uint32_t const oldSeq{oldVal.seq()};
+            std::uint32_t const newSeq{val.seq()};
+
+            // Sequence of 0 indicates a missing sequence number
+            if (oldSeq && newSeq && oldSeq == newSeq)
+            {
+                result = AddOutcome::sameSeq;
+
+                // If the validation key was revoked, update the
+                // existing validation in the byLedger_ set
+                if (val.key() != oldVal.key())
+                {
+                    auto const mapIt = byLedger_.find(oldVal.ledgerID());
+                    if (mapIt != byLedger_.end())
+                    {
+                        auto& validationMap = mapIt->second;
+                        // If a new validation with the same ID was
+                        // reissued we simply replace.
+                        if(oldVal.ledgerID() == val.ledgerID())
+                        {
+                            auto replaceRes = validationMap.emplace(key, val);
+                            // If it was already there, replace
+                            if(!replaceRes.second)
+                                replaceRes.first->second = val;
+                        }
+                        else
+                        {
+                            // If the new validation has a different ID,
+                            // we remove the old.
+                            validationMap.erase(key);
+                            // Erase the set if it is now empty
+                            if (validationMap.empty())
+                                byLedger_.erase(mapIt);
+                        }
+                    }
+                }
+            }
+
+            if (val.signTime() > oldVal.signTime() ||
+                val.key() != oldVal.key())
+            {
+                // This is either a newer validation or a new signing key
+                LedgerID const prevID = [&]() {
+                    // In the normal case, the prevID is the ID of the
+                    // ledger we replace
+                    if (oldVal.ledgerID() != val.ledgerID())
+                        return oldVal.ledgerID();
+                    // In the case the key was revoked and a new validation
+                    // for the same ledger ID was sent, the previous ledger
+                    // is still the one the now revoked validation had
+                    return previousLedgerID;
+                }();
+
+                // Allow impl to take over oldVal
+                maybeStaleValidation.emplace(std::move(oldVal));
+                // Replace old val in the map and set the previous ledger ID
+                ins.first->second.val = val;
+                ins.first->second.prevLedgerID = prevID;
+            }
+            else
+            {
+                // We already have a newer validation from this source
+                result = AddOutcome::stale;
+            }
+        }
+
+        return result;
+    }
 };
 }  // namespace ripple
 #endif
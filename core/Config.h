@@ -54,6 +54,7 @@ enum SizedItemName
     siTreeCacheAge,
     siSLECacheSize,
     siSLECacheAge,
+    siSLECacheBytes,
     siLedgerSize,
     siLedgerAge,
     siLedgerFetch,
@@ -110,6 +111,7 @@ private:
 
 public:
     bool doImport = false;
+    bool doCompactTxnDB = false;
     bool ELB_SUPPORT = false;
 
     std::vector<std::string>    IPS;                    // Peer IPs from rippled.cfg.
@@ -171,6 +173,15 @@ public:
     // Thread pool configuration
     std::size_t                 WORKERS = 0;
 
+    // Threads used to apply the consensus transaction set (0 or 1: serial)
+    std::size_t                 APPLY_THREADS = 0;
+
+    // Adapt the minimum ledger open time to the open ledger backlog
+    bool                        ADAPTIVE_CLOSE = false;
+
+    // Memory budget of the SLE cache in megabytes (0: by node_size)
+    std::size_t                 SLE_CACHE_MB = 0;
+
     // These override the command line client settings
     boost::optional<boost::asio::ip::address_v4> rpc_ip;
     boost::optional<std::uint16_t> rpc_port;
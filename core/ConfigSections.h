@@ -35,7 +35,10 @@ struct ConfigSection
 };
 
 // VFALCO TODO Rename and replace these macros with variables.
+#define SECTION_ACCOUNT_HISTORY_DB      "account_history_db"
+#define SECTION_ADAPTIVE_CLOSE          "adaptive_close"
 #define SECTION_AMENDMENTS              "amendments"
+#define SECTION_APPLY_THREADS           "apply_threads"
 #define SECTION_CLUSTER_NODES           "cluster_nodes"
 #define SECTION_DEBUG_LOGFILE           "debug_logfile"
 #define SECTION_ELB_SUPPORT             "elb_support"
@@ -58,6 +61,7 @@ struct ConfigSection
 #define SECTION_PEER_PRIVATE            "peer_private"
 #define SECTION_PEERS_MAX               "peers_max"
 #define SECTION_RPC_STARTUP             "rpc_startup"
+#define SECTION_SLE_CACHE_MB            "sle_cache_mb"
 #define SECTION_SNTP                    "sntp_servers"
 #define SECTION_SSL_VERIFY              "ssl_verify"
 #define SECTION_SSL_VERIFY_FILE         "ssl_verify_file"
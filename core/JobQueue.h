@@ -28,6 +28,7 @@
 #include <ripple/core/impl/Workers.h>
 #include <ripple/json/json_value.h>
 #include <boost/coroutine/all.hpp>
+#include <functional>
 
 namespace ripple {
 
@@ -166,6 +167,27 @@ public:
     template <class F>
     std::shared_ptr<Coro> postCoro (JobType t, std::string const& name, F&& f);
 
+    /** Calls f(first, last) for consecutive ranges covering [0, n).
+
+        Each range holds `chunk` items, the last one possibly fewer.
+        The caller and up to `threads - 1` jobs claim ranges until none
+        are left, and the caller waits until every range is done. As the
+        caller takes part, this returns even if none of the jobs ever
+        run; a job that runs late claims nothing and never calls f.
+
+        If f throws, the other ranges are still processed and the first
+        exception is rethrown to the caller afterwards.
+
+        @param type The type of the helper jobs.
+        @param name Name of the helper jobs.
+        @param threads The most threads working at once, including the
+                       caller. Zero uses one per hardware thread.
+    */
+    void
+    parallelFor (JobType type, std::string const& name,
+        std::size_t n, std::size_t chunk, std::size_t threads,
+        std::function<void(std::size_t, std::size_t)> f);
+
     /** Jobs waiting at this priority.
     */
     int getJobCount (JobType t) const;
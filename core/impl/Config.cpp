@@ -416,6 +416,15 @@ void Config::loadFromString (std::string const& fileContents)
     if (getSingleSection (secConfig, SECTION_WORKERS, strTemp, j_))
         WORKERS      = beast::lexicalCastThrow <std::size_t> (strTemp);
 
+    if (getSingleSection (secConfig, SECTION_APPLY_THREADS, strTemp, j_))
+        APPLY_THREADS = beast::lexicalCastThrow <std::size_t> (strTemp);
+
+    if (getSingleSection (secConfig, SECTION_ADAPTIVE_CLOSE, strTemp, j_))
+        ADAPTIVE_CLOSE = beast::lexicalCastThrow <bool> (strTemp);
+
+    if (getSingleSection (secConfig, SECTION_SLE_CACHE_MB, strTemp, j_))
+        SLE_CACHE_MB = beast::lexicalCastThrow <std::size_t> (strTemp);
+
     // Do not load trusted validator configuration for standalone mode
     if (! RUN_STANDALONE)
     {
@@ -561,6 +570,8 @@ int Config::getSize (SizedItemName item) const
 
         { siSLECacheSize,       {   4096,   8192,   16384,  65536,      131072  } },
         { siSLECacheAge,        {   30,     60,     90,     120,        300     } },
+        // In kilobytes
+        { siSLECacheBytes,      {   4096,   8192,   16384,  65536,      131072  } },
 
         { siLedgerSize,         {   32,     128,    256,    384,        768     } },
         { siLedgerAge,          {   30,     90,     180,    240,        900     } },
@@ -20,6 +20,11 @@
 #include <BeastConfig.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/basics/contract.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <thread>
 
 namespace ripple {
 
@@ -281,6 +286,85 @@ JobQueue::rendezvous()
     });
 }
 
+void
+JobQueue::parallelFor (JobType type, std::string const& name,
+    std::size_t n, std::size_t chunk, std::size_t threads,
+    std::function<void(std::size_t, std::size_t)> f)
+{
+    assert (chunk != 0);
+    auto const chunks = (n + chunk - 1) / chunk;
+
+    if (chunks <= 1)
+    {
+        if (n != 0)
+            f (0, n);
+        return;
+    }
+
+    // Helper jobs may be dequeued after every range is done and
+    // this function has returned, so they only share this state.
+    struct State
+    {
+        std::function<void(std::size_t, std::size_t)> f;
+        std::size_t n;
+        std::size_t chunk;
+        std::size_t chunks;
+        std::atomic<std::size_t> next {0};
+        std::size_t done = 0;
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable cv;
+    };
+
+    auto state = std::make_shared<State> ();
+    state->f = std::move (f);
+    state->n = n;
+    state->chunk = chunk;
+    state->chunks = chunks;
+
+    auto const work = [](State& s)
+    {
+        for (;;)
+        {
+            auto const c = s.next++;
+            if (c >= s.chunks)
+                return;
+
+            std::exception_ptr error;
+            try
+            {
+                s.f (c * s.chunk, std::min ((c + 1) * s.chunk, s.n));
+            }
+            catch (...)
+            {
+                error = std::current_exception ();
+            }
+
+            std::lock_guard<std::mutex> lock (s.mutex);
+            if (error && ! s.error)
+                s.error = error;
+            if (++s.done == s.chunks)
+                s.cv.notify_all ();
+        }
+    };
+
+    if (threads == 0)
+        threads = std::max (std::thread::hardware_concurrency (), 1u);
+    auto const helpers = std::min (chunks, threads) - 1;
+    for (std::size_t i = 0; i < helpers; ++i)
+    {
+        if (! addJob (type, name, [state, work] (Job&) { work (*state); }))
+            break;
+    }
+
+    work (*state);
+
+    std::unique_lock<std::mutex> lock (state->mutex);
+    state->cv.wait (lock, [&] { return state->done == state->chunks; });
+    if (state->error)
+        std::rethrow_exception (state->error);
+}
+
 JobTypeData&
 JobQueue::getJobTypeData (JobType type)
 {
@@ -76,6 +76,11 @@ public:
     std::size_t
     size ();
 
+    /** Get the number of entries read from the base
+    */
+    std::size_t
+    reads () const;
+
     /** Visit modified entries
     */
     void
@@ -21,14 +21,27 @@
 #define RIPPLE_LEDGER_CACHEDSLES_H_INCLUDED
 
 #include <ripple/basics/chrono.h>
+#include <ripple/basics/hardened_hash.h>
+#include <ripple/basics/UnorderedContainers.h>
 #include <ripple/protocol/STLedgerEntry.h>
-#include <ripple/beast/container/aged_unordered_map.h>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 
 namespace ripple {
 
-/** Caches SLEs by their digest. */
+/** Caches SLEs by their digest.
+
+    The cache is split into shards selected by the digest, each with its
+    own reader/writer lock. A hit only takes the shard's lock shared and
+    records the access time atomically, so concurrent readers do not
+    serialize on each other. The cache is bounded by an estimate of the
+    memory held by its entries rather than by their number.
+*/
 class CachedSLEs
 {
 public:
@@ -43,14 +56,21 @@ public:
     template <class Rep, class Period>
     CachedSLEs (std::chrono::duration<
         Rep, Period> const& timeToLive,
-            Stopwatch& clock)
+            Stopwatch& clock,
+                std::size_t targetBytes = defaultTargetBytes)
         : timeToLive_ (timeToLive)
-        , map_ (clock)
+        , clock_ (clock)
+        , targetBytes_ (targetBytes)
     {
     }
 
     /** Discard expired entries.
 
+        Entries older than the time to live are dropped unless
+        someone else still holds them. Then each shard is trimmed,
+        least recently used first, until it fits its share of
+        the byte budget.
+
         Needs to be called periodically.
     */
     void
@@ -68,44 +88,126 @@ public:
     fetch (digest_type const& digest,
         Handler const& h)
     {
+        auto& shard = shardFor (digest);
+        auto const now = ticks();
         {
-            std::lock_guard<
-                std::mutex> lock(mutex_);
+            boost::shared_lock<
+                boost::shared_mutex> lock(shard.mutex);
             auto iter =
-                map_.find(digest);
-            if (iter != map_.end())
+                shard.map.find(digest);
+            if (iter != shard.map.end())
             {
-                ++hit_;
-                map_.touch(iter);
-                return iter->second;
+                shard.hit.fetch_add (1, std::memory_order_relaxed);
+                iter->second.touched.store (
+                    now, std::memory_order_relaxed);
+                return iter->second.sle;
             }
         }
         auto sle = h();
         if (! sle)
             return nullptr;
+        auto const bytes = estimate (*sle);
         std::lock_guard<
-            std::mutex> lock(mutex_);
-        ++miss_;
+            boost::shared_mutex> lock(shard.mutex);
+        shard.miss.fetch_add (1, std::memory_order_relaxed);
         auto const result =
-            map_.emplace(
-                digest, std::move(sle));
-        if (! result.second)
-            map_.touch(result.first);
-        return  result.first->second;
+            shard.map.emplace(std::piecewise_construct,
+                std::forward_as_tuple(digest),
+                    std::forward_as_tuple(std::move(sle), bytes, now));
+        if (result.second)
+            shard.bytes += bytes;
+        else
+            result.first->second.touched.store (
+                now, std::memory_order_relaxed);
+        return result.first->second.sle;
+    }
+
+    /** Set the approximate number of bytes the cache may hold. */
+    void
+    setTargetBytes (std::size_t bytes)
+    {
+        targetBytes_.store (bytes, std::memory_order_relaxed);
     }
 
     /** Returns the fraction of cache hits. */
     double
     rate() const;
 
+    /** Returns the number of fetches that found their entry. */
+    std::uint64_t
+    hits() const;
+
+    /** Returns the number of fetches that had to load their entry. */
+    std::uint64_t
+    misses() const;
+
+    /** Returns the number of cached entries. */
+    std::size_t
+    size() const;
+
+    /** Returns the estimated number of bytes held by the cache. */
+    std::size_t
+    bytes() const;
+
+    /** Returns the number of entries removed to stay within budget. */
+    std::uint64_t
+    evictions() const
+    {
+        return evicted_.load (std::memory_order_relaxed);
+    }
+
 private:
-    std::size_t hit_ = 0;
-    std::size_t miss_ = 0;
-    std::mutex mutable mutex_;
+    static std::size_t constexpr shardCount = 16;
+    static std::size_t constexpr defaultTargetBytes = 64 * 1024 * 1024;
+
+    struct Entry
+    {
+        value_type sle;
+        std::size_t bytes;
+        std::atomic<Stopwatch::rep> touched;
+
+        Entry (value_type sle_, std::size_t bytes_, Stopwatch::rep now)
+            : sle (std::move(sle_))
+            , bytes (bytes_)
+            , touched (now)
+        {
+        }
+    };
+
+    struct alignas(64) Shard
+    {
+        boost::shared_mutex mutable mutex;
+        hash_map<digest_type, Entry> map;
+        std::size_t bytes = 0;
+        std::atomic<std::uint64_t> hit {0};
+        std::atomic<std::uint64_t> miss {0};
+    };
+
+    Shard&
+    shardFor (digest_type const& digest)
+    {
+        // The digest is already uniformly distributed
+        return shards_[*digest.begin() % shardCount];
+    }
+
+    Stopwatch::rep
+    ticks() const
+    {
+        return clock_.now().time_since_epoch().count();
+    }
+
+    static
+    std::size_t
+    estimate (SLE const& sle)
+    {
+        return sizeof(Entry) + sizeof(SLE) + sle.getHeldBytes();
+    }
+
     Stopwatch::duration timeToLive_;
-    beast::aged_unordered_map <digest_type,
-        value_type, Stopwatch::clock_type,
-            hardened_hash<strong_hash>> map_;
+    Stopwatch& clock_;
+    std::atomic<std::size_t> targetBytes_;
+    std::atomic<std::uint64_t> evicted_ {0};
+    std::array<Shard, shardCount> shards_;
 };
 
 } // ripple
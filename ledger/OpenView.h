@@ -22,6 +22,7 @@
 
 #include <ripple/ledger/RawView.h>
 #include <ripple/ledger/ReadView.h>
+#include <ripple/ledger/detail/FlatMap.h>
 #include <ripple/ledger/detail/RawStateTable.h>
 #include <ripple/basics/qalloc.h>
 #include <ripple/protocol/WFNAmount.h>
@@ -53,10 +54,10 @@ private:
     class txs_iter_impl;
 
     // List of tx, key order
-    using txs_map = std::map<key_type,
+    using txs_map = detail::FlatMap<key_type,
         std::pair<std::shared_ptr<Serializer const>,
         std::shared_ptr<Serializer const>>,
-        std::less<key_type>, qalloc_type<std::pair<key_type const,
+        qalloc_type<std::pair<key_type,
         std::pair<std::shared_ptr<Serializer const>,
         std::shared_ptr<Serializer const>>>, false>>;
 
@@ -24,6 +24,7 @@
 #include <ripple/ledger/RawView.h>
 #include <ripple/ledger/ReadView.h>
 #include <ripple/ledger/TxMeta.h>
+#include <ripple/ledger/detail/FlatMap.h>
 #include <ripple/protocol/TER.h>
 #include <ripple/protocol/WFNAmount.h>
 #include <ripple/beast/utility/Journal.h>
@@ -47,11 +48,15 @@ private:
         modify,
     };
 
-    using items_t = std::map<key_type,
+    // One table exists per applied transaction and holds few entries,
+    // so it stays on the default allocator rather than a qalloc arena.
+    using items_t = FlatMap<key_type,
         std::pair<Action, std::shared_ptr<SLE>>>;
 
     items_t items_;
     WFNAmount dropsDestroyed_ = 0;
+    // Entries fetched from the base view
+    std::size_t mutable reads_ = 0;
 
 public:
     ApplyStateTable() = default;
@@ -90,6 +95,13 @@ public:
     std::size_t
     size () const;
 
+    /** Number of entries read from the base view. */
+    std::size_t
+    reads () const
+    {
+        return reads_;
+    }
+
     void
     visit (ReadView const& base,
         std::function <void (
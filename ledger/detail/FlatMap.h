@@ -0,0 +1,397 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_LEDGER_FLATMAP_H_INCLUDED
+#define RIPPLE_LEDGER_FLATMAP_H_INCLUDED
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ripple {
+namespace detail {
+
+/** Ordered map stored in contiguous memory.
+
+    Elements live in two sorted vectors: a large main run and a small run
+    of recent insertions. Lookups are binary searches over both runs and
+    iteration merges them in key order. When the recent run grows past
+    roughly the square root of the main run it is merged into it, so an
+    insert costs amortized O(sqrt(N)) element moves instead of a node
+    allocation.
+
+    Only the subset of the std::map interface used by the state tables is
+    provided. Unlike std::map, inserting or erasing invalidates every
+    iterator. Const member functions never modify the container, so a
+    const FlatMap may be read from several threads at once.
+*/
+template <class Key, class T,
+    class Allocator = std::allocator<std::pair<Key, T>>>
+class FlatMap
+{
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<Key, T>;
+    using size_type = std::size_t;
+    using allocator_type = typename std::allocator_traits<
+        Allocator>::template rebind_alloc<value_type>;
+
+private:
+    using vector_type = std::vector<value_type, allocator_type>;
+
+    template <bool IsConst>
+    class iter_type
+    {
+    private:
+        using pointer_type = typename std::conditional<IsConst,
+            typename FlatMap::value_type const*,
+                typename FlatMap::value_type*>::type;
+
+        friend class FlatMap;
+
+        pointer_type a_ = nullptr;
+        pointer_type aend_ = nullptr;
+        pointer_type b_ = nullptr;
+        pointer_type bend_ = nullptr;
+
+        iter_type (pointer_type a, pointer_type aend,
+                pointer_type b, pointer_type bend)
+            : a_ (a)
+            , aend_ (aend)
+            , b_ (b)
+            , bend_ (bend)
+        {
+        }
+
+        // True if the current element is in the main run
+        bool
+        inMain() const
+        {
+            if (a_ == aend_)
+                return false;
+            return b_ == bend_ || a_->first < b_->first;
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename FlatMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = pointer_type;
+        using reference = decltype(*std::declval<pointer_type>());
+
+        iter_type() = default;
+
+        template <bool OtherConst, class = typename
+            std::enable_if<IsConst && ! OtherConst>::type>
+        iter_type (iter_type<OtherConst> const& other)
+            : a_ (other.a_)
+            , aend_ (other.aend_)
+            , b_ (other.b_)
+            , bend_ (other.bend_)
+        {
+        }
+
+        reference
+        operator*() const
+        {
+            return inMain() ? *a_ : *b_;
+        }
+
+        pointer
+        operator->() const
+        {
+            return inMain() ? a_ : b_;
+        }
+
+        iter_type&
+        operator++()
+        {
+            if (inMain())
+                ++a_;
+            else
+                ++b_;
+            return *this;
+        }
+
+        iter_type
+        operator++(int)
+        {
+            auto const prev = *this;
+            ++(*this);
+            return prev;
+        }
+
+        friend
+        bool
+        operator== (iter_type const& lhs, iter_type const& rhs)
+        {
+            return lhs.a_ == rhs.a_ && lhs.b_ == rhs.b_;
+        }
+
+        friend
+        bool
+        operator!= (iter_type const& lhs, iter_type const& rhs)
+        {
+            return ! (lhs == rhs);
+        }
+
+        template <bool>
+        friend class iter_type;
+    };
+
+    struct Less
+    {
+        bool
+        operator() (value_type const& v, key_type const& k) const
+        {
+            return v.first < k;
+        }
+
+        bool
+        operator() (key_type const& k, value_type const& v) const
+        {
+            return k < v.first;
+        }
+
+        bool
+        operator() (value_type const& lhs, value_type const& rhs) const
+        {
+            return lhs.first < rhs.first;
+        }
+    };
+
+    vector_type main_;
+    vector_type recent_;
+
+public:
+    using iterator = iter_type<false>;
+    using const_iterator = iter_type<true>;
+
+    explicit
+    FlatMap (allocator_type const& alloc = allocator_type())
+        : main_ (alloc)
+        , recent_ (alloc)
+    {
+    }
+
+    // Both runs of a copy share one freshly selected allocator
+    FlatMap (FlatMap const& other)
+        : FlatMap (other, std::allocator_traits<allocator_type>::
+            select_on_container_copy_construction (
+                other.main_.get_allocator()))
+    {
+    }
+
+    FlatMap (FlatMap&&) = default;
+    FlatMap& operator= (FlatMap&&) = default;
+    FlatMap& operator= (FlatMap const&) = delete;
+
+    size_type
+    size() const
+    {
+        return main_.size() + recent_.size();
+    }
+
+    bool
+    empty() const
+    {
+        return main_.empty() && recent_.empty();
+    }
+
+    void
+    clear()
+    {
+        main_.clear();
+        recent_.clear();
+    }
+
+    iterator
+    begin()
+    {
+        return make<iterator> (main_, main_.begin(), recent_, recent_.begin());
+    }
+
+    const_iterator
+    begin() const
+    {
+        return make<const_iterator> (main_, main_.begin(), recent_, recent_.begin());
+    }
+
+    iterator
+    end()
+    {
+        return make<iterator> (main_, main_.end(), recent_, recent_.end());
+    }
+
+    const_iterator
+    end() const
+    {
+        return make<const_iterator> (main_, main_.end(), recent_, recent_.end());
+    }
+
+    const_iterator
+    cbegin() const
+    {
+        return begin();
+    }
+
+    const_iterator
+    cend() const
+    {
+        return end();
+    }
+
+    iterator
+    lower_bound (key_type const& key)
+    {
+        return make<iterator> (
+            main_, std::lower_bound (main_.begin(), main_.end(), key, Less{}),
+            recent_, std::lower_bound (recent_.begin(), recent_.end(), key, Less{}));
+    }
+
+    const_iterator
+    lower_bound (key_type const& key) const
+    {
+        return make<const_iterator> (
+            main_, std::lower_bound (main_.begin(), main_.end(), key, Less{}),
+            recent_, std::lower_bound (recent_.begin(), recent_.end(), key, Less{}));
+    }
+
+    iterator
+    upper_bound (key_type const& key)
+    {
+        return make<iterator> (
+            main_, std::upper_bound (main_.begin(), main_.end(), key, Less{}),
+            recent_, std::upper_bound (recent_.begin(), recent_.end(), key, Less{}));
+    }
+
+    const_iterator
+    upper_bound (key_type const& key) const
+    {
+        return make<const_iterator> (
+            main_, std::upper_bound (main_.begin(), main_.end(), key, Less{}),
+            recent_, std::upper_bound (recent_.begin(), recent_.end(), key, Less{}));
+    }
+
+    iterator
+    find (key_type const& key)
+    {
+        auto const iter = lower_bound (key);
+        if (iter == end() || iter->first != key)
+            return end();
+        return iter;
+    }
+
+    const_iterator
+    find (key_type const& key) const
+    {
+        auto const iter = lower_bound (key);
+        if (iter == end() || iter->first != key)
+            return end();
+        return iter;
+    }
+
+    /** Insert a value constructed from args if key is not present.
+
+        @return The element with the key, and true if it was inserted.
+    */
+    template <class... Args>
+    std::pair<iterator, bool>
+    emplace (key_type const& key, Args&&... args)
+    {
+        auto const iter = find (key);
+        if (iter != end())
+            return { iter, false };
+
+        recent_.emplace (
+            std::lower_bound (recent_.begin(), recent_.end(), key, Less{}),
+                std::piecewise_construct, std::forward_as_tuple (key),
+                    std::forward_as_tuple (std::forward<Args>(args)...));
+
+        // Keep the recent run near the square root of the main run
+        if (recent_.size() > minRecent &&
+                recent_.size() * recent_.size() > main_.size())
+            merge();
+
+        return { lower_bound (key), true };
+    }
+
+    /** Remove the element at iter. */
+    void
+    erase (const_iterator iter)
+    {
+        assert (iter != end());
+        if (iter.inMain())
+            main_.erase (main_.begin() + (iter.a_ - main_.data()));
+        else
+            recent_.erase (recent_.begin() + (iter.b_ - recent_.data()));
+    }
+
+private:
+    enum
+    {
+        minRecent = 16
+    };
+
+    FlatMap (FlatMap const& other, allocator_type const& alloc)
+        : main_ (alloc)
+        , recent_ (alloc)
+    {
+        main_.reserve (other.size());
+        std::merge (other.main_.begin(), other.main_.end(),
+            other.recent_.begin(), other.recent_.end(),
+                std::back_inserter (main_), Less{});
+    }
+
+    template <class Iter, class Vector, class VectorIter>
+    static
+    Iter
+    make (Vector& m, VectorIter a, Vector& r, VectorIter b)
+    {
+        return Iter (m.data() + (a - m.begin()), m.data() + m.size(),
+            r.data() + (b - r.begin()), r.data() + r.size());
+    }
+
+    void
+    merge()
+    {
+        vector_type merged (main_.get_allocator());
+        merged.reserve (main_.size() + recent_.size());
+        std::merge (
+            std::make_move_iterator (main_.begin()),
+            std::make_move_iterator (main_.end()),
+            std::make_move_iterator (recent_.begin()),
+            std::make_move_iterator (recent_.end()),
+                std::back_inserter (merged), Less{});
+        main_.swap (merged);
+        recent_.clear();
+    }
+};
+
+} // detail
+} // ripple
+
+#endif
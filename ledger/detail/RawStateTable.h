@@ -22,8 +22,8 @@
 
 #include <ripple/ledger/RawView.h>
 #include <ripple/ledger/ReadView.h>
+#include <ripple/ledger/detail/FlatMap.h>
 #include <ripple/basics/qalloc.h>
-#include <map>
 #include <utility>
 
 namespace ripple {
@@ -89,9 +89,9 @@ private:
 
     class sles_iter_impl;
 
-    using items_t = std::map<key_type,
+    using items_t = FlatMap<key_type,
         std::pair<Action, std::shared_ptr<SLE>>,
-        std::less<key_type>, qalloc_type<std::pair<key_type const,
+        qalloc_type<std::pair<key_type,
         std::pair<Action, std::shared_ptr<SLE>>>, false>>;
 
     items_t items_;
@@ -326,7 +326,10 @@ ApplyStateTable::read (ReadView const& base,
 {
     auto const iter = items_.find(k.key);
     if (iter == items_.end())
+    {
+        ++reads_;
         return base.read(k);
+    }
     auto const& item = iter->second;
     auto const& sle = item.second;
     switch (item.first)
@@ -347,20 +350,16 @@ std::shared_ptr<SLE>
 ApplyStateTable::peek (ReadView const& base,
     Keylet const& k)
 {
-    auto iter = items_.lower_bound(k.key);
-    if (iter == items_.end() ||
-        iter->first != k.key)
+    auto iter = items_.find(k.key);
+    if (iter == items_.end())
     {
+        ++reads_;
         auto const sle = base.read(k);
         if (! sle)
             return nullptr;
         // Make our own copy
-        using namespace std;
-        iter = items_.emplace_hint (iter,
-            piecewise_construct,
-                forward_as_tuple(sle->key()),
-                    forward_as_tuple(Action::cache,
-                        make_shared<SLE>(*sle)));
+        iter = items_.emplace (sle->key(),
+            Action::cache, std::make_shared<SLE>(*sle)).first;
         return iter->second.second;
     }
     auto const& item = iter->second;
@@ -410,11 +409,8 @@ void
 ApplyStateTable::rawErase (ReadView const& base,
     std::shared_ptr<SLE> const& sle)
 {
-    using namespace std;
     auto const result = items_.emplace(
-        piecewise_construct,
-            forward_as_tuple(sle->key()),
-                forward_as_tuple(Action::erase, sle));
+        sle->key(), Action::erase, sle);
     if (result.second)
         return;
     auto& item = result.first->second;
@@ -439,15 +435,11 @@ ApplyStateTable::insert (ReadView const& base,
     std::shared_ptr<SLE> const& sle)
 {
     auto const iter =
-        items_.lower_bound(sle->key());
-    if (iter == items_.end() ||
-        iter->first != sle->key())
+        items_.find(sle->key());
+    if (iter == items_.end())
     {
-        using namespace std;
-        items_.emplace_hint(iter,
-            piecewise_construct,
-                forward_as_tuple(sle->key()),
-                    forward_as_tuple(Action::insert, sle));
+        items_.emplace(sle->key(),
+            Action::insert, sle);
         return;
     }
     auto& item = iter->second;
@@ -471,14 +463,11 @@ ApplyStateTable::replace (ReadView const& base,
     std::shared_ptr<SLE> const& sle)
 {
     auto const iter =
-        items_.lower_bound(sle->key());
-    if (iter == items_.end() ||
-        iter->first != sle->key())
+        items_.find(sle->key());
+    if (iter == items_.end())
     {
-        using namespace std;
-        items_.emplace_hint(iter, piecewise_construct,
-            forward_as_tuple(sle->key()),
-                forward_as_tuple(Action::modify, sle));
+        items_.emplace(sle->key(),
+            Action::modify, sle);
         return;
     }
     auto& item = iter->second;
@@ -44,6 +44,12 @@ ApplyViewImpl::size ()
     return items_.size ();
 }
 
+std::size_t
+ApplyViewImpl::reads () const
+{
+    return items_.reads ();
+}
+
 void
 ApplyViewImpl::visit (
     OpenView& to,
@@ -19,6 +19,8 @@
 
 #include <BeastConfig.h>
 #include <ripple/ledger/CachedSLEs.h>
+#include <algorithm>
+#include <utility>
 #include <vector>
 
 namespace ripple {
@@ -26,24 +28,57 @@ namespace ripple {
 void
 CachedSLEs::expire()
 {
-    std::vector<
-        std::shared_ptr<void const>> trash;
+    auto const expireTime = ticks() -
+        std::chrono::duration_cast<Stopwatch::duration>(
+            timeToLive_).count();
+    auto const budget = targetBytes_.load() / shardCount;
+
+    for (auto& shard : shards_)
     {
-        auto const expireTime =
-            map_.clock().now() - timeToLive_;
+        std::vector<
+            std::shared_ptr<void const>> trash;
         std::lock_guard<
-            std::mutex> lock(mutex_);
-        for (auto iter = map_.chronological.begin();
-            iter != map_.chronological.end(); ++iter)
+            boost::shared_mutex> lock(shard.mutex);
+
+        for (auto iter = shard.map.begin();
+            iter != shard.map.end();)
         {
-            if (iter.when() > expireTime)
-                break;
-            if (iter->second.unique())
+            if (iter->second.touched.load() <= expireTime &&
+                iter->second.sle.unique())
             {
+                shard.bytes -= iter->second.bytes;
                 trash.emplace_back(
-                    std::move(iter->second));
-                iter = map_.erase(iter);
+                    std::move(iter->second.sle));
+                iter = shard.map.erase(iter);
             }
+            else
+            {
+                ++iter;
+            }
+        }
+
+        if (shard.bytes <= budget)
+            continue;
+
+        // Over budget: drop the least recently used entries
+        std::vector<std::pair<
+            Stopwatch::rep, digest_type>> order;
+        order.reserve(shard.map.size());
+        for (auto const& item : shard.map)
+            order.emplace_back(
+                item.second.touched.load(), item.first);
+        std::sort(order.begin(), order.end());
+
+        for (auto const& victim : order)
+        {
+            if (shard.bytes <= budget)
+                break;
+            auto const iter = shard.map.find(victim.second);
+            shard.bytes -= iter->second.bytes;
+            trash.emplace_back(
+                std::move(iter->second.sle));
+            shard.map.erase(iter);
+            ++evicted_;
         }
     }
 }
@@ -51,12 +86,55 @@ CachedSLEs::expire()
 double
 CachedSLEs::rate() const
 {
-    std::lock_guard<
-        std::mutex> lock(mutex_);
-    auto const tot = hit_ + miss_;
+    auto const hit = hits();
+    auto const tot = hit + misses();
     if (tot == 0)
         return 0;
-    return double(hit_) / tot;
+    return double(hit) / tot;
+}
+
+std::uint64_t
+CachedSLEs::hits() const
+{
+    std::uint64_t ret = 0;
+    for (auto const& shard : shards_)
+        ret += shard.hit.load(std::memory_order_relaxed);
+    return ret;
+}
+
+std::uint64_t
+CachedSLEs::misses() const
+{
+    std::uint64_t ret = 0;
+    for (auto const& shard : shards_)
+        ret += shard.miss.load(std::memory_order_relaxed);
+    return ret;
+}
+
+std::size_t
+CachedSLEs::size() const
+{
+    std::size_t ret = 0;
+    for (auto const& shard : shards_)
+    {
+        boost::shared_lock<
+            boost::shared_mutex> lock(shard.mutex);
+        ret += shard.map.size();
+    }
+    return ret;
+}
+
+std::size_t
+CachedSLEs::bytes() const
+{
+    std::size_t ret = 0;
+    for (auto const& shard : shards_)
+    {
+        boost::shared_lock<
+            boost::shared_mutex> lock(shard.mutex);
+        ret += shard.bytes;
+    }
+    return ret;
 }
 
 } // ripple
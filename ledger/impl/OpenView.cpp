@@ -272,7 +272,7 @@ OpenView::rawTxInsert (key_type const& key,
                 const& metaData)
 {
     auto const result = txs_.emplace (key,
-        std::make_pair(txn, metaData));
+        txn, metaData);
     if (! result.second)
         LogicError("rawTxInsert: duplicate TX id" +
             to_string(key));
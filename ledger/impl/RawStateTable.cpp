@@ -240,10 +240,7 @@ RawStateTable::erase(
 {
     // The base invariant is checked during apply
     auto const result = items_.emplace(
-        std::piecewise_construct,
-            std::forward_as_tuple(sle->key()),
-                std::forward_as_tuple(
-                    Action::erase, sle));
+        sle->key(), Action::erase, sle);
     if (result.second)
         return;
     auto& item = result.first->second;
@@ -267,10 +264,7 @@ RawStateTable::insert(
     std::shared_ptr<SLE> const& sle)
 {
     auto const result = items_.emplace(
-        std::piecewise_construct,
-            std::forward_as_tuple(sle->key()),
-                std::forward_as_tuple(
-                    Action::insert, sle));
+        sle->key(), Action::insert, sle);
     if (result.second)
         return;
     auto& item = result.first->second;
@@ -294,10 +288,7 @@ RawStateTable::replace(
     std::shared_ptr<SLE> const& sle)
 {
     auto const result = items_.emplace(
-        std::piecewise_construct,
-            std::forward_as_tuple(sle->key()),
-                std::forward_as_tuple(
-                    Action::replace, sle));
+        sle->key(), Action::replace, sle);
     if (result.second)
         return;
     auto& item = result.first->second;
@@ -1178,6 +1178,7 @@ public:
             {   "account_objects",      &RPCParser::parseAccountItems,          1,  5   },
             {   "account_offers",       &RPCParser::parseAccountItems,          1,  4   },
             {   "account_tx",           &RPCParser::parseAccountTransactions,   1,  8   },
+            {   "apply_profile",        &RPCParser::parseAsIs,                  0,  0   },
             {   "book_offers",          &RPCParser::parseBookOffers,            2,  7   },
             {   "can_delete",           &RPCParser::parseCanDelete,             0,  1   },
             {   "channel_authorize",    &RPCParser::parseChannelAuthorize,      3,  3   },
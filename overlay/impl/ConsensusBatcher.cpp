@@ -0,0 +1,282 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <BeastConfig.h>
+#include <ripple/overlay/impl/ConsensusBatcher.h>
+#include <ripple/overlay/impl/Tuning.h>
+#include <ripple/app/misc/HashRouter.h>
+#include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/core/JobQueue.h>
+#include <ripple/overlay/Overlay.h>
+#include <ripple/resource/Fees.h>
+#include <type_traits>
+
+namespace ripple {
+
+ConsensusBatcher::ConsensusBatcher (
+        Application& app, beast::Journal journal)
+    : app_ (app)
+    , j_ (journal)
+    , trustedValidations_ (std::make_shared<Queue<ValidationItem>> (
+        jtVALIDATION_t, true))
+    , untrustedValidations_ (std::make_shared<Queue<ValidationItem>> (
+        jtVALIDATION_ut, false))
+    , trustedProposals_ (std::make_shared<Queue<ProposalItem>> (
+        jtPROPOSAL_t, true))
+    , untrustedProposals_ (std::make_shared<Queue<ProposalItem>> (
+        jtPROPOSAL_ut, false))
+{
+}
+
+void
+ConsensusBatcher::addValidation (std::shared_ptr<Peer> const& peer,
+    STValidation::pointer const& val, uint256 const& rawID,
+    bool isTrusted, std::shared_ptr<protocol::TMValidation> const& packet)
+{
+    push (isTrusted ? trustedValidations_ : untrustedValidations_,
+        ValidationItem {peer, peer->cluster (),
+            std::to_string (peer->id ()), val, rawID, packet});
+}
+
+void
+ConsensusBatcher::addProposal (std::shared_ptr<Peer> const& peer,
+    RCLCxPeerPos const& peerPos, bool isTrusted,
+    std::shared_ptr<protocol::TMProposeSet> const& packet)
+{
+    push (isTrusted ? trustedProposals_ : untrustedProposals_,
+        ProposalItem {peer, peer->cluster (), peerPos, packet});
+}
+
+template <class Item>
+void
+ConsensusBatcher::push (QueuePtr<Item> const& queue, Item&& item)
+{
+    {
+        std::lock_guard<std::mutex> lock (queue->mutex);
+        queue->items.push_back (std::move (item));
+        if (queue->scheduled)
+            return;
+        queue->scheduled = true;
+    }
+
+    schedule (queue);
+}
+
+template <class Item>
+void
+ConsensusBatcher::schedule (QueuePtr<Item> const& queue)
+{
+    char const* const name = std::is_same<Item, ValidationItem>::value ?
+        "recvValidation->checkValidations" : "recvPropose->checkProposals";
+
+    if (app_.getJobQueue ().addJob (queue->type, name,
+            [this, queue] (Job&) { drain (queue); }))
+        return;
+
+    // The job queue is stopping
+    std::lock_guard<std::mutex> lock (queue->mutex);
+    queue->items.clear ();
+    queue->scheduled = false;
+}
+
+template <class Item>
+void
+ConsensusBatcher::drain (QueuePtr<Item> const& queue)
+{
+    std::vector<Item> batch;
+    {
+        std::lock_guard<std::mutex> lock (queue->mutex);
+        if (queue->items.size () <= Tuning::maxConsensusBatch)
+        {
+            batch.swap (queue->items);
+        }
+        else
+        {
+            auto const first = queue->items.begin ();
+            auto const last = first + Tuning::maxConsensusBatch;
+            batch.assign (std::make_move_iterator (first),
+                std::make_move_iterator (last));
+            queue->items.erase (first, last);
+        }
+    }
+
+    process (batch, queue->trusted);
+
+    {
+        std::lock_guard<std::mutex> lock (queue->mutex);
+        if (queue->items.empty ())
+        {
+            queue->scheduled = false;
+            return;
+        }
+    }
+
+    // More arrived while this batch was processed. Let other
+    // jobs run before the next one.
+    schedule (queue);
+}
+
+void
+ConsensusBatcher::process (
+    std::vector<ValidationItem>& batch, bool trusted)
+{
+    JLOG (j_.trace()) << "Checking " << batch.size () <<
+        (trusted ? " trusted" : " UNTRUSTED") << " validations";
+
+    // Zero for an invalid or failed validation
+    std::vector<uint256> signingHashes (batch.size ());
+    std::vector<char> valid (batch.size (), 0);
+
+    app_.getJobQueue ().parallelFor (
+        trusted ? jtVALIDATION_t : jtVALIDATION_ut, "checkConsensusBatch",
+        batch.size (), Tuning::consensusBatchChunk, 0,
+        [&batch, &signingHashes, &valid](std::size_t first, std::size_t last)
+        {
+            for (auto i = first; i < last; ++i)
+            {
+                auto const& item = batch[i];
+                try
+                {
+                    signingHashes[i] = item.val->getSigningHash ();
+                    valid[i] = item.cluster ||
+                        item.val->isValid (signingHashes[i]);
+                }
+                catch (std::exception const&)
+                {
+                }
+            }
+        });
+
+    std::vector<std::pair<STValidation::pointer, std::string>> vals;
+    std::vector<std::size_t> indexes;
+    vals.reserve (batch.size ());
+    indexes.reserve (batch.size ());
+    for (std::size_t i = 0; i < batch.size (); ++i)
+    {
+        if (valid[i])
+        {
+            vals.emplace_back (batch[i].val, batch[i].source);
+            indexes.push_back (i);
+        }
+        else
+        {
+            JLOG (j_.warn()) << "Validation is invalid";
+            app_.getHashRouter ().setFlags (batch[i].rawID, SF_BAD);
+            if (auto peer = batch[i].peer.lock ())
+                peer->charge (Resource::feeInvalidRequest);
+        }
+    }
+
+    if (vals.empty ())
+        return;
+
+    std::vector<bool> relay;
+    try
+    {
+        relay = app_.getOPs ().recvValidations (vals);
+    }
+    catch (std::exception const& e)
+    {
+        JLOG (j_.warn()) << "Exception processing " << vals.size () <<
+            " validations, retrying one at a time: " << e.what ();
+
+        // Don't let one validation cost the others their relay
+        relay.assign (vals.size (), false);
+        for (std::size_t k = 0; k < vals.size (); ++k)
+        {
+            try
+            {
+                relay[k] = app_.getOPs ().recvValidation (
+                    vals[k].first, vals[k].second);
+            }
+            catch (std::exception const& e)
+            {
+                JLOG (j_.warn()) << "Exception processing validation: " <<
+                    e.what ();
+            }
+        }
+    }
+
+    for (std::size_t k = 0; k < indexes.size (); ++k)
+    {
+        auto const i = indexes[k];
+        if (relay[k])
+            app_.overlay ().relay (*batch[i].packet, signingHashes[i]);
+    }
+}
+
+void
+ConsensusBatcher::process (
+    std::vector<ProposalItem>& batch, bool trusted)
+{
+    JLOG (j_.trace()) << "Checking " << batch.size () <<
+        (trusted ? " trusted" : " UNTRUSTED") << " proposals";
+
+    std::vector<char> valid (batch.size (), 0);
+
+    app_.getJobQueue ().parallelFor (
+        trusted ? jtPROPOSAL_t : jtPROPOSAL_ut, "checkConsensusBatch",
+        batch.size (), Tuning::consensusBatchChunk, 0,
+        [&batch, &valid](std::size_t first, std::size_t last)
+        {
+            for (auto i = first; i < last; ++i)
+            {
+                auto const& item = batch[i];
+                valid[i] = item.cluster || item.peerPos.checkSign ();
+            }
+        });
+
+    std::vector<std::pair<RCLCxPeerPos,
+        std::shared_ptr<protocol::TMProposeSet>>> proposals;
+    proposals.reserve (batch.size ());
+    for (std::size_t i = 0; i < batch.size (); ++i)
+    {
+        auto& item = batch[i];
+        if (! valid[i])
+        {
+            JLOG (j_.warn()) << "Proposal fails sig check";
+            if (auto peer = item.peer.lock ())
+                peer->charge (Resource::feeInvalidSignature);
+            continue;
+        }
+
+        if (trusted)
+        {
+            proposals.emplace_back (item.peerPos, item.packet);
+        }
+        else if (app_.getOPs ().getConsensusLCL () ==
+            item.peerPos.proposal ().prevLedger ())
+        {
+            // relay untrusted proposal
+            JLOG (j_.trace()) << "relaying UNTRUSTED proposal";
+            app_.overlay ().relay (*item.packet,
+                item.peerPos.suppressionID ());
+        }
+        else
+        {
+            JLOG (j_.debug()) << "Not relaying UNTRUSTED proposal";
+        }
+    }
+
+    if (! proposals.empty ())
+        app_.getOPs ().processTrustedProposals (proposals);
+}
+
+} // ripple
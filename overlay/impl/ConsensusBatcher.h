@@ -0,0 +1,147 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_OVERLAY_CONSENSUSBATCHER_H_INCLUDED
+#define RIPPLE_OVERLAY_CONSENSUSBATCHER_H_INCLUDED
+
+#include <ripple/app/consensus/RCLCxPeerPos.h>
+#include <ripple/app/main/Application.h>
+#include <ripple/core/Job.h>
+#include <ripple/overlay/Peer.h>
+#include <ripple/protocol/STValidation.h>
+#include <ripple/beast/utility/Journal.h>
+#include "ripple.pb.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ripple {
+
+/** Checks validations and proposals from peers in batches.
+
+    Instead of one job per message, messages are queued by kind and
+    trust, and one job drains each queue. The signatures of a batch
+    are verified in parallel on jobs of the same type, then the whole
+    batch is handed to Validations or RCLConsensus under a single lock
+    acquisition.
+
+    The queues fill while a drain job waits to run, so batches grow
+    with the flood of messages around each ledger close and shrink to
+    single messages when traffic is light.
+
+    Thread safety:
+        All members may be called concurrently.
+*/
+class ConsensusBatcher
+{
+public:
+    ConsensusBatcher (Application& app, beast::Journal journal);
+
+    ConsensusBatcher (ConsensusBatcher const&) = delete;
+    ConsensusBatcher& operator= (ConsensusBatcher const&) = delete;
+
+    /** Queue a validation whose signature has not been checked.
+
+        @param rawID The hash the validation is suppressed under. It is
+                     marked bad if the signature does not verify.
+    */
+    void
+    addValidation (std::shared_ptr<Peer> const& peer,
+        STValidation::pointer const& val, uint256 const& rawID,
+        bool isTrusted,
+        std::shared_ptr<protocol::TMValidation> const& packet);
+
+    /** Queue a proposal whose signature has not been checked. */
+    void
+    addProposal (std::shared_ptr<Peer> const& peer,
+        RCLCxPeerPos const& peerPos, bool isTrusted,
+        std::shared_ptr<protocol::TMProposeSet> const& packet);
+
+private:
+    struct ValidationItem
+    {
+        std::weak_ptr<Peer> peer;
+        bool cluster;
+        std::string source;
+        STValidation::pointer val;
+        uint256 rawID;
+        std::shared_ptr<protocol::TMValidation> packet;
+    };
+
+    struct ProposalItem
+    {
+        std::weak_ptr<Peer> peer;
+        bool cluster;
+        RCLCxPeerPos peerPos;
+        std::shared_ptr<protocol::TMProposeSet> packet;
+    };
+
+    template <class Item>
+    struct Queue
+    {
+        Queue (JobType type_, bool trusted_)
+            : type (type_)
+            , trusted (trusted_)
+        {
+        }
+
+        JobType const type;
+        bool const trusted;
+        std::mutex mutex;
+        std::vector<Item> items;
+
+        // Whether a job to drain the queue is pending or running
+        bool scheduled = false;
+    };
+
+    template <class Item>
+    using QueuePtr = std::shared_ptr<Queue<Item>>;
+
+    template <class Item>
+    void
+    push (QueuePtr<Item> const& queue, Item&& item);
+
+    template <class Item>
+    void
+    schedule (QueuePtr<Item> const& queue);
+
+    template <class Item>
+    void
+    drain (QueuePtr<Item> const& queue);
+
+    void
+    process (std::vector<ValidationItem>& batch, bool trusted);
+
+    void
+    process (std::vector<ProposalItem>& batch, bool trusted);
+
+    Application& app_;
+    beast::Journal j_;
+
+    QueuePtr<ValidationItem> const trustedValidations_;
+    QueuePtr<ValidationItem> const untrustedValidations_;
+    QueuePtr<ProposalItem> const trustedProposals_;
+    QueuePtr<ProposalItem> const untrustedProposals_;
+};
+
+} // ripple
+
+#endif
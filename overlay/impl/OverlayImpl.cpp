@@ -144,6 +144,7 @@ OverlayImpl::OverlayImpl (
     , m_resolver (resolver)
     , next_id_(1)
     , timer_count_(0)
+    , consensusBatcher_ (app_, app_.journal("Overlay"))
 {
     beast::PropertyStream::Source::add (m_peerFinder.get());
 }
@@ -23,6 +23,7 @@
 #include <ripple/app/main/Application.h>
 #include <ripple/core/Job.h>
 #include <ripple/overlay/Overlay.h>
+#include <ripple/overlay/impl/ConsensusBatcher.h>
 #include <ripple/overlay/impl/TrafficCount.h>
 #include <ripple/server/Handoff.h>
 #include <ripple/rpc/ServerHandler.h>
@@ -119,6 +120,7 @@ private:
     Resolver& m_resolver;
     std::atomic <Peer::id_t> next_id_;
     int timer_count_;
+    ConsensusBatcher consensusBatcher_;
 
     //--------------------------------------------------------------------------
 
@@ -157,6 +159,12 @@ public:
         return setup_;
     }
 
+    ConsensusBatcher&
+    consensusBatcher()
+    {
+        return consensusBatcher_;
+    }
+
     Handoff
     onHandoff (std::unique_ptr <beast::asio::ssl_bundle>&& bundle,
         http_request_type&& request,
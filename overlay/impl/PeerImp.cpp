@@ -24,6 +24,7 @@
 #include <ripple/app/ledger/InboundLedgers.h>
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/ledger/InboundTransactions.h>
+#include <ripple/app/misc/BatchVerifier.h>
 #include <ripple/app/misc/HashRouter.h>
 #include <ripple/app/misc/LoadFeeTrack.h>
 #include <ripple/app/misc/NetworkOPs.h>
@@ -35,6 +36,7 @@
 #include <ripple/beast/core/SemanticVersion.h>
 #include <ripple/overlay/Cluster.h>
 #include <ripple/protocol/digest.h>
+#include <ripple/protocol/HashPrefix.h>
 #include <peersafe/app/table/TableSync.h>
 
 #include <boost/algorithm/string/predicate.hpp>
@@ -1047,28 +1049,53 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMTransaction> const& m)
         return;
     }
 
-    SerialIter sit (makeSlice(m->rawtransaction()));
+    auto const raw = makeSlice(m->rawtransaction());
+
+    // The transaction ID of a canonically serialized transaction is
+    // the hash of its raw bytes, so duplicates (most relayed copies)
+    // are dropped here without building an STTx.
+    uint256 const rawID = sha512Half(HashPrefix::transactionID, raw);
+
+    int flags;
+
+    constexpr std::chrono::seconds tx_interval = 10s;
+    if (! app_.getHashRouter ().shouldProcess (
+        rawID, id_, flags, clock_type::now(), tx_interval))
+    {
+        // we have seen this transaction recently
+        if (flags & SF_BAD)
+        {
+            fee_ = Resource::feeInvalidSignature;
+            JLOG(p_journal_.debug()) << "Ignoring known bad tx " <<
+                rawID;
+        }
+
+        return;
+    }
+
+    SerialIter sit (raw);
 
     try
     {
         auto stx = std::make_shared<STTx const>(sit);
         uint256 txID = stx->getTransactionID ();
 
-        int flags;
-
-        constexpr std::chrono::seconds tx_interval = 10s;
-        if (! app_.getHashRouter ().shouldProcess (
-            txID, id_, flags, clock_type::now(), tx_interval))
+        if (txID != rawID)
         {
-            // we have seen this transaction recently
-            if (flags & SF_BAD)
+            // Not canonically serialized: the raw hash is not the
+            // transaction ID, so suppress by the real ID as well.
+            if (! app_.getHashRouter ().shouldProcess (
+                txID, id_, flags, clock_type::now(), tx_interval))
             {
-                fee_ = Resource::feeInvalidSignature;
-                JLOG(p_journal_.debug()) << "Ignoring known bad tx " <<
-                    txID;
-            }
+                if (flags & SF_BAD)
+                {
+                    fee_ = Resource::feeInvalidSignature;
+                    JLOG(p_journal_.debug()) << "Ignoring known bad tx " <<
+                        txID;
+                }
 
-            return;
+                return;
+            }
         }
 
         JLOG(p_journal_.debug()) << "Got tx " << txID;
@@ -1091,9 +1118,12 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMTransaction> const& m)
             }
         }
 
-        // The maximum number of transactions to have in the job queue.
+        // The maximum number of transactions to have in the job queue,
+        // counting those waiting for their signatures to be checked.
         constexpr int max_transactions = 250;
-        if (app_.getJobQueue().getJobCount(jtTRANSACTION) > max_transactions)
+        if (app_.getJobQueue().getJobCount(jtTRANSACTION) +
+            static_cast<int>(app_.getBatchVerifier().size()) >
+                max_transactions)
         {
             JLOG(p_journal_.info()) << "Transaction queue is full";
         }
@@ -1101,6 +1131,17 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMTransaction> const& m)
         {
             JLOG(p_journal_.trace()) << "No new transactions until synchronized";
         }
+        else if (checkSignature)
+        {
+            // Ed25519 signatures are verified in batches, and
+            // checkTransaction finds the result in the HashRouter.
+            app_.getBatchVerifier ().add (stx,
+                [weak = std::weak_ptr<PeerImp>(shared_from_this()),
+                flags, stx] () {
+                    if (auto peer = weak.lock())
+                        peer->checkTransaction(flags, true, stx);
+                });
+        }
         else
         {
             app_.getJobQueue ().addJob (
@@ -1115,6 +1156,8 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMTransaction> const& m)
     }
     catch (std::exception const&)
     {
+        // Remember the blob so later copies are dropped unparsed.
+        app_.getHashRouter ().setFlags (rawID, SF_BAD);
         JLOG(p_journal_.warn()) << "Transaction invalid: " <<
             strHex(m->rawtransaction ());
     }
@@ -1273,7 +1316,6 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMProposeSet> const& m)
         return;
     }
 
-    PublicKey const publicKey (makeSlice(set.nodepubkey()));
     NetClock::time_point const closeTime { NetClock::duration{set.closetime()} };
     Slice signature (set.signature().data(), set.signature ().size());
 
@@ -1281,9 +1323,10 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMProposeSet> const& m)
     memcpy (proposeHash.begin (), set.currenttxhash ().data (), 32);
     memcpy (prevLedger.begin (), set.previousledger ().data (), 32);
 
+    // Suppress on the raw message fields before building anything
     uint256 suppression = proposalUniqueId (
         proposeHash, prevLedger, set.proposeseq(),
-        closeTime, publicKey.slice(), signature);
+        closeTime, makeSlice(set.nodepubkey()), signature);
 
     if (! app_.getHashRouter ().addSuppressionPeer (suppression, id_))
     {
@@ -1291,6 +1334,8 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMProposeSet> const& m)
         return;
     }
 
+    PublicKey const publicKey (makeSlice(set.nodepubkey()));
+
     if (!app_.getValidationPublicKey().empty() &&
         publicKey == app_.getValidationPublicKey())
     {
@@ -1323,13 +1368,8 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMProposeSet> const& m)
         RCLCxPeerPos::Proposal{prevLedger, set.proposeseq (), proposeHash, closeTime,
             app_.timeKeeper().closeTime(),calcNodeID(publicKey)});
 
-    std::weak_ptr<PeerImp> weak = shared_from_this();
-    app_.getJobQueue ().addJob (
-        isTrusted ? jtPROPOSAL_t : jtPROPOSAL_ut, "recvPropose->checkPropose",
-        [weak, m, proposal] (Job& job) {
-            if (auto peer = weak.lock())
-                peer->checkPropose(job, m, proposal);
-        });
+    overlay_.consensusBatcher().addProposal (
+        shared_from_this(), proposal, isTrusted, m);
 }
 
 void
@@ -1601,6 +1641,26 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMValidation> const& m)
         return;
     }
 
+    // Validations are suppressed by the hash of their raw bytes, so
+    // duplicates are dropped before they are deserialized. Those that
+    // fail to parse or carry a bad signature are remembered and charged
+    // every time.
+    auto const rawID = sha512Half(makeSlice(m->validation()));
+    int flags;
+    if (! app_.getHashRouter ().addSuppressionPeer(rawID, id_, flags))
+    {
+        if (flags & SF_BAD)
+        {
+            JLOG(p_journal_.debug()) << "Validation: known bad";
+            fee_ = Resource::feeUnwantedData;
+        }
+        else
+        {
+            JLOG(p_journal_.trace()) << "Validation: duplicate";
+        }
+        return;
+    }
+
     try
     {
         STValidation::pointer val;
@@ -1621,13 +1681,6 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMValidation> const& m)
             return;
         }
 
-        if (! app_.getHashRouter ().addSuppressionPeer(
-            sha512Half(makeSlice(m->validation())), id_))
-        {
-            JLOG(p_journal_.trace()) << "Validation: duplicate";
-            return;
-        }
-
         auto const isTrusted =
             app_.validators().trusted(val->getSignerPublic ());
 
@@ -1638,18 +1691,8 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMValidation> const& m)
         }
         if (isTrusted || !app_.getFeeTrack ().isLoadedLocal ())
         {
-            std::weak_ptr<PeerImp> weak = shared_from_this();
-            app_.getJobQueue ().addJob (
-                isTrusted ? jtVALIDATION_t : jtVALIDATION_ut,
-                "recvValidation->checkValidation",
-                [weak, val, isTrusted, m] (Job&)
-                {
-                    if (auto peer = weak.lock())
-                        peer->checkValidation(
-                            val,
-                            isTrusted,
-                            m);
-                });
+            overlay_.consensusBatcher().addValidation (
+                shared_from_this(), val, rawID, isTrusted, m);
         }
         else
         {
@@ -1661,6 +1704,7 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMValidation> const& m)
     {
         JLOG(p_journal_.warn()) <<
             "Validation: Exception, " << e.what();
+        app_.getHashRouter ().setFlags (rawID, SF_BAD);
         fee_ = Resource::feeInvalidRequest;
     }
 }
@@ -1929,78 +1973,6 @@ PeerImp::checkTransaction (int flags,
     }
 }
 
-// Called from our JobQueue
-void
-PeerImp::checkPropose (Job& job,
-    std::shared_ptr <protocol::TMProposeSet> const& packet,
-        RCLCxPeerPos peerPos)
-{
-    bool isTrusted = (job.getType () == jtPROPOSAL_t);
-
-    JLOG(p_journal_.trace()) <<
-        "Checking " << (isTrusted ? "trusted" : "UNTRUSTED") << " proposal";
-
-    assert (packet);
-    protocol::TMProposeSet& set = *packet;
-
-    if (! cluster() && !peerPos.checkSign ())
-    {
-        JLOG(p_journal_.warn()) <<
-            "Proposal fails sig check";
-        charge (Resource::feeInvalidSignature);
-        return;
-    }
-
-    if (isTrusted)
-    {
-        app_.getOPs ().processTrustedProposal (
-            peerPos, packet, calcNodeID (publicKey_));
-    }
-    else
-    {
-        if (app_.getOPs().getConsensusLCL() == peerPos.proposal().prevLedger())
-        {
-            // relay untrusted proposal
-            JLOG(p_journal_.trace()) <<
-                "relaying UNTRUSTED proposal";
-            overlay_.relay(set, peerPos.suppressionID());
-        }
-        else
-        {
-            JLOG(p_journal_.debug()) <<
-                "Not relaying UNTRUSTED proposal";
-        }
-    }
-}
-
-void
-PeerImp::checkValidation (STValidation::pointer val,
-    bool isTrusted, std::shared_ptr<protocol::TMValidation> const& packet)
-{
-    try
-    {
-        // VFALCO Which functions throw?
-        uint256 signingHash = val->getSigningHash();
-        if (! cluster() && !val->isValid (signingHash))
-        {
-            JLOG(p_journal_.warn()) <<
-                "Validation is invalid";
-            charge (Resource::feeInvalidRequest);
-            return;
-        }
-
-        if (app_.getOPs ().recvValidation(
-                val, std::to_string(id())))
-            overlay_.relay(*packet, signingHash);
-    }
-    catch (std::exception const&)
-    {
-        JLOG(p_journal_.trace()) <<
-            "Exception processing validation";
-        charge (Resource::feeInvalidRequest);
-    }
-}
-
 // Returns the set of peers that can help us get
 // the TX tree with the specified root hash.
 //
@@ -448,15 +448,6 @@ private:
     checkTransaction (int flags, bool checkSignature,
         std::shared_ptr<STTx const> const& stx);
 
-    void
-    checkPropose (Job& job,
-        std::shared_ptr<protocol::TMProposeSet> const& packet,
-            RCLCxPeerPos peerPos);
-
-    void
-    checkValidation (STValidation::pointer val,
-        bool isTrusted, std::shared_ptr<protocol::TMValidation> const& packet);
-
     void
     getLedger (std::shared_ptr<protocol::TMGetLedger> const&packet);
 
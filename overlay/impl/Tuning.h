@@ -74,6 +74,12 @@ enum
 
     /** How often to log send queue size */
     sendQueueLogFreq    =    64,
+
+    /** The most validations or proposals checked in one job */
+    maxConsensusBatch   =   256,
+
+    /** How many signatures of a batch one thread checks at a time */
+    consensusBatchChunk =    16,
 };
 
 } // Tuning
@@ -23,6 +23,7 @@
 #include <ripple/overlay/Message.h>
 #include <ripple/overlay/Peer.h>
 
+#include <boost/container/flat_set.hpp>
 #include <set>
 
 namespace ripple {
@@ -154,9 +155,9 @@ struct peer_in_cluster
 /** Select all peers that are in the specified set */
 struct peer_in_set
 {
-    std::set <Peer::id_t> const& peerSet;
+    boost::container::flat_set <Peer::id_t> const& peerSet;
 
-    peer_in_set (std::set<Peer::id_t> const& peers)
+    peer_in_set (boost::container::flat_set<Peer::id_t> const& peers)
         : peerSet (peers)
     { }
 
@@ -51,6 +51,9 @@ JSS ( TransferRate );               // in: TransferRate
 JSS (TransferFeeMin);
 JSS (TransferFeeMax);
 JSS ( historical_perminute );       // historical_perminute
+JSS ( SLE_cache_bytes );            // out: GetCounts
+JSS ( SLE_cache_size );             // out: GetCounts
+JSS ( SLE_evictions );              // out: GetCounts
 JSS ( SLE_hit_rate );               // out: GetCounts
 JSS ( SettleDelay );                // in: TransactionSign
 JSS ( SendMax );                    // in: TransactionSign
@@ -118,6 +121,8 @@ JSS ( alternatives );               // out: PathRequest, RipplePathFind
 JSS ( amendment_blocked );          // out: NetworkOPs
 JSS ( amendments );                 // in: AccountObjects, out: NetworkOPs
 JSS ( amount );                     // out: AccountChannels
+JSS ( apply_profile );              // out: ApplyProfile
+JSS ( apply_stages );               // out: NetworkOPs
 JSS ( asks );                       // out: Subscribe
 JSS ( assets );                     // out: GatewayBalances
 JSS ( escrows );
@@ -130,6 +135,7 @@ JSS ( balances );                   // out: GatewayBalances
 JSS ( base );                       // out: LogLevel
 JSS ( base_fee );                   // out: NetworkOPs
 JSS ( base_fee_wfn );               // out: NetworkOPs
+JSS ( batches );                    // out: NetworkOPs
 JSS ( bids );                       // out: Subscribe
 JSS ( binary );                     // in: AccountTX, LedgerEntry,
                                     //     AccountTxOld, Tx LedgerData
@@ -405,6 +411,7 @@ JSS ( reserve_inc );                // out: NetworkOPs
 JSS ( reserve_inc_wfn );            // out: NetworkOPs
 JSS ( response );                   // websocket
 JSS ( result );                     // RPC
+JSS ( results );                    // out: SubmitBatch
 JSS ( ripple_lines );               // out: NetworkOPs
 JSS ( ripple_state );               // in: LedgerEntr
 JSS ( ripplerpc );                  // ripple RPC version
@@ -423,6 +430,8 @@ JSS ( seq );                        // in: LedgerEntry;
                                     // out: NetworkOPs, RPCSub, AccountOffers,
                                     //      ValidatorList
 JSS ( seqNum );                     // out: LedgerToJson
+JSS ( serialnode_cache_size );      // out: GetCounts
+JSS ( serialnode_hit_rate );        // out: GetCounts
 JSS ( server_state );               // out: NetworkOPs
 JSS ( server_status );              // out: NetworkOPs
 JSS ( settle_delay );               // out: AccountChannels
@@ -486,6 +495,7 @@ JSS ( trusted_validator_keys );     // out: ValidatorList
 JSS ( tx );                         // out: STTx, AccountTx*
 JSS ( tx_blob );                    // in/out: Submit,
                                     // in: TransactionSign, AccountTx*
+JSS ( tx_blobs );                   // in: SubmitBatch
 JSS ( tx_hash );                    // in: TransactionEntry
 JSS ( tx_json );                    // in/out: TransactionSign
                                     // out: TransactionEntry
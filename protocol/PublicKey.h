@@ -35,6 +35,7 @@
 #include <cstring>
 #include <ostream>
 #include <utility>
+#include <vector>
 
 namespace ripple {
 
@@ -246,6 +247,25 @@ verify (PublicKey const& publicKey,
     Slice const& sig,
     bool mustBeFullyCanonical = true);
 
+/** A signature to be checked by verifyBatch. */
+struct SignatureCheck
+{
+    PublicKey const* publicKey;
+    Slice message;
+    Slice signature;
+    bool mustBeFullyCanonical;
+};
+
+/** Verify several signatures on messages.
+    Equivalent to calling verify on each entry, except that
+    Ed25519 signatures are checked together using batch
+    verification, which is much cheaper per signature.
+
+    @return One result per entry, in the same order.
+*/
+std::vector<bool>
+verifyBatch (std::vector<SignatureCheck> const& checks);
+
 /** Encrypt a plain text.*/
 Blob 
 encrypt(const Blob& passBlob, PublicKey const& publicKey);
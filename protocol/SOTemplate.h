@@ -92,8 +92,23 @@ public:
     /** Add an element to the template. */
     void push_back (SOElement const& r);
 
-    /** Retrieve the position of a named field. */
-    int getIndex (SField const&) const;
+    /** Retrieve the position of a named field.
+
+        This is a table lookup by field number, so it is
+        cheap enough to do on every field access.
+
+        @return The position, or -1 if the field is not
+                part of this template.
+    */
+    int getIndex (SField const& f) const
+    {
+        // Fields registered after the template was built
+        // cannot be part of it
+        auto const num = static_cast<std::size_t>(f.getNum ());
+        if (num >= mIndex.size ())
+            return -1;
+        return mIndex[num];
+    }
 
     SOE_Flags
     style(SField const& sf) const
@@ -55,6 +55,17 @@ public:
 
     STLedgerEntry (STObject const& object, uint256 const& index);
 
+    /** Create an entry whose fields are parsed on first access.
+
+        `owner` keeps `data` alive for as long as the entry refers
+        to it. Falls back to a full parse when the data cannot be
+        indexed lazily.
+
+        @see STObject::setLazy
+    */
+    STLedgerEntry (std::shared_ptr<void const> owner,
+        Slice const& data, uint256 const& index);
+
     STBase*
     copy (std::size_t n, void* buf) const override
     {
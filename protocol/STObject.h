@@ -32,6 +32,7 @@
 #include <boost/iterator/transform_iterator.hpp>
 #include <boost/optional.hpp>
 #include <cassert>
+#include <memory>
 #include <stdexcept>
 #include <type_traits>
 #include <utility>
@@ -266,8 +267,14 @@ private:
 
     using list_type = std::vector<detail::STVar>;
 
-    list_type v_;
+    // Serialized fields awaiting parsing, see setLazy
+    struct Lazy;
+
+    // Mutable because lazily parsed fields are
+    // filled in on first access through const members.
+    mutable list_type v_;
     SOTemplate const* mType;
+    std::unique_ptr<Lazy> lazy_;
 
 public:
     using iterator = boost::transform_iterator<
@@ -277,7 +284,7 @@ public:
 
 	STObject();
     STObject(STObject&&);
-    STObject(STObject const&) = default;
+    STObject(STObject const&);
     STObject (const SOTemplate & type, SField const& name);
     STObject (const SOTemplate & type, SerialIter & sit, SField const& name);
     STObject (SerialIter& sit, SField const& name);
@@ -285,7 +292,7 @@ public:
         : STObject(sit, name)
     {
     }
-    STObject& operator= (STObject const&) = default;
+    STObject& operator= (STObject const& other);
     STObject& operator= (STObject&& other);
 
     explicit STObject (SField const& name);
@@ -306,11 +313,15 @@ public:
 
     iterator begin() const
     {
+        if (lazy_)
+            materialize();
         return iterator(v_.begin());
     }
 
     iterator end() const
     {
+        if (lazy_)
+            materialize();
         return iterator(v_.end());
     }
 
@@ -339,6 +350,27 @@ public:
     void set (const SOTemplate&);
     bool set (SerialIter& u, int depth = 0);
 
+    /** Index serialized fields without parsing them.
+
+        Each field is parsed on first access, so a reader that only
+        needs a few fields of a large object does not pay for the
+        rest. Any mutation parses the whole object first. `owner`
+        must keep `data` alive and is held until then.
+
+        @return `false` if the data does not match the template or
+                contains a field that cannot be indexed, in which
+                case the caller should parse it in full.
+    */
+    bool setLazy (SOTemplate const& type,
+        std::shared_ptr<void const> owner, Slice const& data);
+
+    /** Returns the approximate number of bytes this object holds.
+
+        This is the serialized size of the fields, or the size of the
+        buffer a lazy object refers to, plus the storage of each field.
+    */
+    std::size_t getHeldBytes () const;
+
     virtual SerializedTypeID getSType () const override
     {
         return STI_OBJECT;
@@ -379,6 +411,8 @@ public:
     std::size_t
     emplace_back(Args&&... args)
     {
+        if (lazy_)
+            detachLazy();
         v_.emplace_back(std::forward<Args>(args)...);
         return v_.size() - 1;
     }
@@ -398,22 +432,35 @@ public:
 
     const STBase& peekAtIndex (int offset) const
     {
+        if (lazy_)
+            materialize(offset);
         return v_[offset].get();
     }
     STBase& getIndex(int offset)
     {
+        if (lazy_)
+            detachLazy();
         return v_[offset].get();
     }
     const STBase* peekAtPIndex (int offset) const
     {
+        if (lazy_)
+            materialize(offset);
         return &v_[offset].get();
     }
     STBase* getPIndex (int offset)
     {
+        if (lazy_)
+            detachLazy();
         return &v_[offset].get();
     }
 
-    int getFieldIndex (SField const& field) const;
+    int getFieldIndex (SField const& field) const
+    {
+        if (mType != nullptr)
+            return mType->getIndex (field);
+        return getFreeFieldIndex (field);
+    }
     SField const& getFieldSType (int index) const;
 
     const STBase& peekAtField (SField const& field) const;
@@ -541,6 +588,19 @@ public:
 private:
     void add (Serializer & s, bool withSigningFields) const;
 
+    // Position of a field in an object without a template
+    int getFreeFieldIndex (SField const& field) const;
+
+    // Parse one lazily indexed field, or all of them
+    void materialize (int index) const;
+    void materialize () const;
+
+    // True when the indexed data is exactly what add() would produce
+    bool isCanonical () const;
+
+    // Parse everything and stop referring to the serialized data
+    void detachLazy ();
+
     // Sort the entries in an STObject into the order that they will be
     // serialized.  Note: they are not sorted into pointer value order, they
     // are sorted by SField::fieldCode.
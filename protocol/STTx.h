@@ -181,19 +181,14 @@ public:
     std::pair<bool, std::string>
     checkSign(bool allowMultiSign) const;
 
-    // SQL Functions with metadata.
+    /** Check the signatures of several transactions.
+        Same as calling checkSign on each, but single signatures
+        are verified together, see verifyBatch.
+        @return One result per transaction, in the same order.
+    */
     static
-    std::string const&
-    getMetaSQLInsertReplaceHeader ();
-
-    std::string getMetaSQL (
-        std::uint32_t inLedger, std::string const& escapedMetaData) const;
-
-    std::string getMetaSQL (
-        Serializer rawTxn,
-        std::uint32_t inLedger,
-        char status,
-        std::string const& escapedMetaData) const;
+    std::vector<std::pair<bool, std::string>>
+    checkSign(std::vector<STTx const*> const& txs, bool allowMultiSign);
 
     void setParentTxID(const uint256 &tidParent) { tidParent_ = tidParent; }
 	uint256 getParentTxID() const { return tidParent_;  }
@@ -22,10 +22,13 @@
 #include <ripple/protocol/digest.h>
 #include <ripple/protocol/impl/secp256k1.h>
 #include <ripple/basics/contract.h>
+#include <ripple/basics/GenerationalCache.h>
 #include <ripple/basics/strHex.h>
 #include <ripple/beast/core/ByteOrder.h>
 #include <boost/multiprecision/cpp_int.hpp>
 #include <ed25519-donna/ed25519.h>
+#include <array>
+#include <cstring>
 #include <type_traits>
 //#include <gmencrypt/hardencrypt/HardEncryptObj.h>
 
@@ -231,6 +234,59 @@ publicKeyType (Slice const& slice)
     return boost::none;
 }
 
+namespace detail {
+
+/** Parsed secp256k1 public keys, by compressed key.
+
+    Parsing a compressed key decompresses the point, which is a
+    noticeable part of verifying a signature. The same keys sign
+    over and over (validators, proposers, busy accounts), so the
+    parsed form is kept around.
+*/
+class ParsedKeyCache
+{
+public:
+    using key_type = std::array<std::uint8_t, 33>;
+
+    bool
+    parse (Slice const& pk, secp256k1_pubkey& out)
+    {
+        if (pk.size() != std::tuple_size<key_type>::value)
+            return secp256k1_ec_pubkey_parse (secp256k1Context(), &out,
+                reinterpret_cast<unsigned char const*>(pk.data()),
+                    pk.size()) == 1;
+
+        key_type key;
+        std::memcpy (key.data(), pk.data(), key.size());
+        if (auto const parsed = cache_.find (key))
+        {
+            out = *parsed;
+            return true;
+        }
+
+        if (secp256k1_ec_pubkey_parse (secp256k1Context(), &out,
+                key.data(), key.size()) != 1)
+            return false;
+
+        cache_.insert (key, out);
+        return true;
+    }
+
+private:
+    // Entries per generation in each shard
+    GenerationalCache<key_type, secp256k1_pubkey> cache_ {512};
+};
+
+static
+ParsedKeyCache&
+parsedKeyCache()
+{
+    static ParsedKeyCache cache;
+    return cache;
+}
+
+} // detail
+
 bool
 verifyDigest (PublicKey const& publicKey,
     uint256 const& digest,
@@ -250,12 +306,8 @@ verifyDigest (PublicKey const& publicKey,
 			return false;
 
 		secp256k1_pubkey pubkey_imp;
-		if (secp256k1_ec_pubkey_parse(
-			secp256k1Context(),
-			&pubkey_imp,
-			reinterpret_cast<unsigned char const*>(
-				publicKey.data()),
-			publicKey.size()) != 1)
+		if (! detail::parsedKeyCache().parse(
+				publicKey.slice(), pubkey_imp))
 			return false;
 
 		secp256k1_ecdsa_signature sig_imp;
@@ -354,6 +406,53 @@ verify (PublicKey const& publicKey,
     return false;
 }
 
+std::vector<bool>
+verifyBatch (std::vector<SignatureCheck> const& checks)
+{
+    std::vector<bool> result (checks.size(), false);
+
+    // Ed25519 signatures are gathered for a single batch check,
+    // anything else is verified on its own.
+    std::vector<std::size_t> index;
+    std::vector<unsigned char const*> m;
+    std::vector<std::size_t> mlen;
+    std::vector<unsigned char const*> pk;
+    std::vector<unsigned char const*> rs;
+
+    for (std::size_t i = 0; i < checks.size(); ++i)
+    {
+        auto const& check = checks[i];
+        if (publicKeyType(*check.publicKey) != KeyType::ed25519)
+        {
+            result[i] = verify (*check.publicKey, check.message,
+                check.signature, check.mustBeFullyCanonical);
+            continue;
+        }
+
+        if (! ed25519Canonical(check.signature))
+            continue;
+
+        index.push_back (i);
+        m.push_back (check.message.data());
+        mlen.push_back (check.message.size());
+        // Strip the 0xED prefix, as verify does
+        pk.push_back (check.publicKey->data() + 1);
+        rs.push_back (check.signature.data());
+    }
+
+    if (! index.empty())
+    {
+        // On failure the batch is retried one signature at a
+        // time internally, so every entry gets its own result.
+        std::vector<int> valid (index.size(), 0);
+        ed25519_sign_open_batch (m.data(), mlen.data(), pk.data(),
+            rs.data(), index.size(), valid.data());
+        for (std::size_t i = 0; i < index.size(); ++i)
+            result[index[i]] = (valid[i] == 1);
+    }
+
+    return result;
+}
 
 Blob
 encrypt(const Blob& passBlob,PublicKey const& publicKey)
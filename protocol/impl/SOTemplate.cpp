@@ -51,13 +51,4 @@ void SOTemplate::push_back (SOElement const& r)
     mTypes.push_back (std::make_unique<SOElement const> (r));
 }
 
-int SOTemplate::getIndex (SField const& f) const
-{
-    // The mapping table should be large enough for any possible field
-    //
-    assert (f.getNum () < mIndex.size ());
-
-    return mIndex[f.getNum ()];
-}
-
 } // ripple
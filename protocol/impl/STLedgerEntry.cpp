@@ -64,6 +64,40 @@ STLedgerEntry::STLedgerEntry (
     setSLEType ();
 }
 
+STLedgerEntry::STLedgerEntry (
+        std::shared_ptr<void const> owner,
+        Slice const& data,
+        uint256 const& index)
+    : STObject (sfLedgerEntry)
+    , key_ (index)
+{
+    // The entry type is the lowest field code, so
+    // canonical data always starts with it.
+    LedgerFormats::Item const* format = nullptr;
+    {
+        SerialIter sit (data);
+        int type;
+        int field;
+        if (sit.getBytesLeft () >= 3)
+        {
+            sit.getFieldID (type, field);
+            if (SField::getField (type, field) == sfLedgerEntryType)
+                format = LedgerFormats::getInstance().findByType (
+                    static_cast <LedgerEntryType> (sit.get16 ()));
+        }
+    }
+
+    if (format && setLazy (format->elements, std::move (owner), data))
+    {
+        type_ = format->getType ();
+        return;
+    }
+
+    SerialIter sit (data);
+    set (sit);
+    setSLEType ();
+}
+
 void STLedgerEntry::setSLEType ()
 {
     auto format = LedgerFormats::getInstance().findByType (
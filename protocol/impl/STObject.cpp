@@ -25,9 +25,127 @@
 #include <ripple/protocol/STBlob.h>
 #include <peersafe/protocol/STMap256.h>
 #include <ripple/basics/Log.h>
+#include <atomic>
+#include <mutex>
 
 namespace ripple {
 
+struct STObject::Lazy
+{
+    std::shared_ptr<void const> owner;
+    Slice data;
+
+    // Serialized value of each template field, empty when absent
+    std::vector<Slice> fields;
+
+    // Set once the corresponding entry of v_ holds the parsed value
+    std::unique_ptr<std::atomic<bool>[]> ready;
+    std::atomic<bool> complete {false};
+
+    // Whether data is exactly what add() would produce. Field order
+    // is checked while indexing, the encodings on the first add().
+    enum class Canonical { unknown, yes, no };
+    std::atomic<Canonical> canonical {Canonical::unknown};
+
+    std::mutex mutex;
+};
+
+namespace {
+
+bool skipField (SerialIter& sit, int type);
+
+// Advance past the fields of an inner object and its end marker
+bool skipObject (SerialIter& sit)
+{
+    while (! sit.empty ())
+    {
+        int type;
+        int field;
+        sit.getFieldID (type, field);
+
+        if ((type == STI_OBJECT) && (field == 1))
+            return true;
+        if ((type == STI_ARRAY) && (field == 1))
+            return false;
+        if (! skipField (sit, type))
+            return false;
+    }
+    return false;
+}
+
+// Advance past a serialized value without constructing it. Returns
+// false for anything malformed or for types we do not know the
+// layout of, in which case the caller falls back to a full parse.
+bool skipField (SerialIter& sit, int type)
+{
+    switch (type)
+    {
+    case STI_UINT8:     sit.skip (1); return true;
+    case STI_UINT16:    sit.skip (2); return true;
+    case STI_UINT32:    sit.skip (4); return true;
+    case STI_UINT64:    sit.skip (8); return true;
+    case STI_HASH128:   sit.skip (16); return true;
+    case STI_HASH160:   sit.skip (20); return true;
+    case STI_HASH256:   sit.skip (32); return true;
+
+    case STI_AMOUNT:
+        // Non-native amounts carry a currency and an issuer
+        if (sit.get64 () & STAmount::cNotNative)
+            sit.skip (40);
+        return true;
+
+    case STI_VL:
+    case STI_ACCOUNT:
+    case STI_VECTOR256:
+        sit.skip (sit.getVLDataLength ());
+        return true;
+
+    case STI_PATHSET:
+        for (;;)
+        {
+            int const iType = sit.get8 ();
+
+            if (iType == STPathElement::typeNone)
+                return true;
+            if (iType == STPathElement::typeBoundary)
+                continue;
+            if (iType & ~STPathElement::typeAll)
+                return false;
+            if (iType & STPathElement::typeAccount)
+                sit.skip (20);
+            if (iType & STPathElement::typeCurrency)
+                sit.skip (20);
+            if (iType & STPathElement::typeIssuer)
+                sit.skip (20);
+        }
+
+    case STI_OBJECT:
+        return skipObject (sit);
+
+    case STI_ARRAY:
+        // Elements are always parsed as objects, see STArray
+        while (! sit.empty ())
+        {
+            int iType;
+            int field;
+            sit.getFieldID (iType, field);
+
+            if ((iType == STI_ARRAY) && (field == 1))
+                return true;
+            if ((iType == STI_OBJECT) && (field == 1))
+                return false;
+            if (! skipObject (sit))
+                return false;
+        }
+        return false;
+
+    default:
+        return false;
+    }
+}
+
+} // namespace
+
 STObject::~STObject()
 {
 #if 0
@@ -45,7 +163,18 @@ STObject::STObject(STObject&& other)
     : STBase(other.getFName())
     , v_(std::move(other.v_))
     , mType(other.mType)
+    , lazy_(std::move(other.lazy_))
+{
+}
+
+STObject::STObject (STObject const& other)
+    : STBase (other)
+    , mType (other.mType)
 {
+    // Copies are made to be modified, so parse everything now
+    if (other.lazy_)
+        other.materialize ();
+    v_ = other.v_;
 }
 
 STObject::STObject (SField const& name)
@@ -79,17 +208,33 @@ STObject::STObject (SerialIter& sit, SField const& name)
     set(sit, 0);
 }
 
+STObject&
+STObject::operator= (STObject const& other)
+{
+    if (this == &other)
+        return *this;
+    if (other.lazy_)
+        other.materialize ();
+    STBase::operator= (other);
+    mType = other.mType;
+    v_ = other.v_;
+    lazy_.reset();
+    return *this;
+}
+
 STObject&
 STObject::operator= (STObject&& other)
 {
     setFName(other.getFName());
     mType = other.mType;
     v_ = std::move(other.v_);
+    lazy_ = std::move(other.lazy_);
     return *this;
 }
 
 void STObject::set (const SOTemplate& type)
 {
+    lazy_.reset();
     v_.clear();
     v_.reserve(type.size());
     mType = &type;
@@ -105,6 +250,9 @@ void STObject::set (const SOTemplate& type)
 
 bool STObject::setType (const SOTemplate& type)
 {
+    if (lazy_)
+        detachLazy();
+
     bool valid = true;
     mType = &type;
     decltype(v_) v;
@@ -174,6 +322,7 @@ bool STObject::set (SerialIter& sit, int depth)
 {
     bool reachedEndOfObject = false;
 
+    lazy_.reset();
     v_.clear();
 
     // Consume data in the pipe until we run out or reach the end
@@ -225,6 +374,215 @@ bool STObject::set (SerialIter& sit, int depth)
     return reachedEndOfObject;
 }
 
+bool STObject::setLazy (SOTemplate const& type,
+    std::shared_ptr<void const> owner, Slice const& data)
+{
+    auto lazy = std::make_unique<Lazy>();
+    lazy->fields.resize (type.size ());
+
+    try
+    {
+        SerialIter sit (data);
+        int lastCode = 0;
+
+        while (! sit.empty ())
+        {
+            int fieldType;
+            int field;
+            sit.getFieldID (fieldType, field);
+
+            auto const& fn = SField::getField (fieldType, field);
+            if (fn.isInvalid ())
+                return false;
+
+            // Leave leftover and duplicate fields to the full parse
+            int const index = type.getIndex (fn);
+            if (index == -1 || ! lazy->fields[index].empty ())
+                return false;
+
+            auto const begin = data.size () - sit.getBytesLeft ();
+            if (! skipField (sit, fieldType))
+                return false;
+            lazy->fields[index] = Slice (data.data () + begin,
+                data.size () - sit.getBytesLeft () - begin);
+
+            if ((fn.fieldCode <= lastCode) || ! fn.isBinary ())
+                lazy->canonical.store (Lazy::Canonical::no,
+                    std::memory_order_relaxed);
+            lastCode = fn.fieldCode;
+        }
+    }
+    catch (std::exception const&)
+    {
+        return false;
+    }
+
+    auto const elements = type.all ();
+    for (std::size_t i = 0; i < elements.size (); ++i)
+    {
+        if (lazy->fields[i].empty () &&
+                elements[i]->flags == SOE_REQUIRED)
+            return false;
+    }
+
+    lazy->owner = std::move (owner);
+    lazy->data = data;
+    lazy->ready.reset (new std::atomic<bool>[elements.size ()]);
+
+    v_.clear ();
+    v_.reserve (elements.size ());
+    for (std::size_t i = 0; i < elements.size (); ++i)
+    {
+        v_.emplace_back (detail::nonPresentObject, elements[i]->e_field);
+        lazy->ready[i].store (lazy->fields[i].empty (),
+            std::memory_order_relaxed);
+    }
+    mType = &type;
+    lazy_ = std::move (lazy);
+
+    // setType rejects explicitly serialized default values, so
+    // look at those few fields now rather than on first access.
+    try
+    {
+        for (std::size_t i = 0; i < elements.size (); ++i)
+        {
+            if (elements[i]->flags == SOE_DEFAULT &&
+                ! lazy_->fields[i].empty () &&
+                peekAtIndex (i).isDefault ())
+            {
+                lazy_.reset ();
+                v_.clear ();
+                mType = nullptr;
+                return false;
+            }
+        }
+    }
+    catch (std::exception const&)
+    {
+        lazy_.reset ();
+        v_.clear ();
+        mType = nullptr;
+        return false;
+    }
+
+    return true;
+}
+
+std::size_t
+STObject::getHeldBytes () const
+{
+    auto const bytes = v_.capacity () * sizeof (detail::STVar);
+
+    // The buffer stays referenced until the object is modified, even
+    // once every field has been parsed from it.
+    if (lazy_)
+        return bytes + sizeof (Lazy) + lazy_->data.size () +
+            lazy_->fields.size () *
+                (sizeof (Slice) + sizeof (std::atomic<bool>));
+
+    Serializer s;
+    add (s, true);
+    return bytes + s.size ();
+}
+
+void STObject::materialize (int index) const
+{
+    auto& lazy = *lazy_;
+
+    if (lazy.ready[index].load (std::memory_order_acquire))
+        return;
+
+    std::lock_guard<std::mutex> lock (lazy.mutex);
+    if (lazy.ready[index].load (std::memory_order_relaxed))
+        return;
+
+    SField const& fn = v_[index]->getFName ();
+    SerialIter sit (lazy.fields[index]);
+    detail::STVar v (sit, fn);
+
+    STObject* const obj = dynamic_cast <STObject*> (&v.get());
+    if (obj && (obj->setTypeFromSField (fn) == typeSetFail))
+        Throw<std::runtime_error> ("field deserialization error");
+
+    v_[index] = std::move (v);
+    lazy.ready[index].store (true, std::memory_order_release);
+}
+
+void STObject::materialize () const
+{
+    if (lazy_->complete.load (std::memory_order_acquire))
+        return;
+
+    for (std::size_t i = 0; i < v_.size (); ++i)
+        materialize (i);
+
+    lazy_->complete.store (true, std::memory_order_release);
+}
+
+bool STObject::isCanonical () const
+{
+    auto& lazy = *lazy_;
+
+    auto state = lazy.canonical.load (std::memory_order_acquire);
+    if (state != Lazy::Canonical::unknown)
+        return state == Lazy::Canonical::yes;
+
+    // These types have exactly one encoding for each value they can
+    // hold. Anything else, nested objects and arrays in particular,
+    // is parsed and encoded again to see if it comes out the same.
+    auto const fixed = [](int type)
+    {
+        switch (type)
+        {
+        case STI_UINT8:
+        case STI_UINT16:
+        case STI_UINT32:
+        case STI_UINT64:
+        case STI_HASH128:
+        case STI_HASH160:
+        case STI_HASH256:
+        case STI_VL:
+        case STI_ACCOUNT:
+            return true;
+        default:
+            return false;
+        }
+    };
+
+    state = Lazy::Canonical::yes;
+    for (std::size_t i = 0; i < v_.size (); ++i)
+    {
+        auto const& data = lazy.fields[i];
+        if (data.empty () || fixed (v_[i]->getFName ().fieldType))
+            continue;
+
+        materialize (i);
+
+        Serializer s (static_cast<int> (data.size ()));
+        auto const& field = v_[i].get ();
+        field.add (s);
+        if (dynamic_cast<STArray const*> (&field) != nullptr)
+            s.addFieldID (STI_ARRAY, 1);
+        else if (dynamic_cast<STObject const*> (&field) != nullptr)
+            s.addFieldID (STI_OBJECT, 1);
+
+        if (s.slice () != data)
+        {
+            state = Lazy::Canonical::no;
+            break;
+        }
+    }
+
+    lazy.canonical.store (state, std::memory_order_release);
+    return state == Lazy::Canonical::yes;
+}
+
+void STObject::detachLazy ()
+{
+    materialize ();
+    lazy_.reset ();
+}
+
 bool STObject::hasMatchingEntry (const STBase& t)
 {
     const STBase* o = peekAtPField (t.getFName ());
@@ -247,6 +605,8 @@ std::string STObject::getFullText () const
     }
     else ret = "{";
 
+    if (lazy_)
+        materialize ();
     for (auto const& elem : v_)
     {
         if (elem->getSType () != STI_NOTPRESENT)
@@ -268,6 +628,8 @@ std::string STObject::getText () const
 {
     std::string ret = "{";
     bool first = false;
+    if (lazy_)
+        materialize ();
     for (auto const& elem : v_)
     {
         if (! first)
@@ -311,11 +673,8 @@ uint256 STObject::getSigningHash (std::uint32_t prefix) const
     return s.getSHA512Half ();
 }
 
-int STObject::getFieldIndex (SField const& field) const
+int STObject::getFreeFieldIndex (SField const& field) const
 {
-    if (mType != nullptr)
-        return mType->getIndex (field);
-
     int i = 0;
     for (auto const& elem : v_)
     {
@@ -349,6 +708,8 @@ STBase& STObject::getField (SField const& field)
 SField const&
 STObject::getFieldSType (int index) const
 {
+    if (lazy_)
+        materialize (index);
     return v_[index]->getFName ();
 }
 
@@ -384,6 +745,9 @@ bool STObject::isFieldPresent (SField const& field) const
     if (index == -1)
         return false;
 
+    if (lazy_)
+        return ! lazy_->fields[index].empty ();
+
     return peekAtIndex (index).getSType () != STI_NOTPRESENT;
 }
 
@@ -463,6 +827,9 @@ void STObject::makeFieldAbsent (SField const& field)
     if (index == -1)
         Throw<std::runtime_error> ("Field not found");
 
+    if (lazy_)
+        detachLazy();
+
     const STBase& f = peekAtIndex (index);
 
     if (f.getSType () == STI_NOTPRESENT)
@@ -484,6 +851,8 @@ bool STObject::delField (SField const& field)
 
 void STObject::delField (int index)
 {
+    if (lazy_)
+        detachLazy();
     v_.erase (v_.begin () + index);
 }
 
@@ -583,6 +952,8 @@ const STObject& STObject::getFieldObject(SField const& field) const
 void
 STObject::set (std::unique_ptr<STBase> v)
 {
+    if (lazy_)
+        detachLazy();
     auto const i =
         getFieldIndex(v->getFName());
     if (i != -1)
@@ -670,6 +1041,8 @@ Json::Value STObject::getJson (int options) const
 
     // TODO(tom): this variable is never changed...?
     int index = 1;
+    if (lazy_)
+        materialize ();
     for (auto const& elem : v_)
     {
         if (elem->getSType () != STI_NOTPRESENT)
@@ -687,6 +1060,10 @@ bool STObject::operator== (const STObject& obj) const
 {
     // This is not particularly efficient, and only compares data elements
     // with binary representations
+    if (lazy_)
+        materialize ();
+    if (obj.lazy_)
+        obj.materialize ();
     int matches = 0;
     for (auto const& t1 : v_)
     {
@@ -727,6 +1104,17 @@ bool STObject::operator== (const STObject& obj) const
 
 void STObject::add (Serializer& s, bool withSigningFields) const
 {
+    if (lazy_)
+    {
+        // Nothing has changed since the data was indexed
+        if (withSigningFields && isCanonical ())
+        {
+            s.addRaw (lazy_->data.data (), lazy_->data.size ());
+            return;
+        }
+        materialize ();
+    }
+
     std::map<int, STBase const*> fields;
     for (auto const& e : v_)
     {
@@ -764,6 +1152,9 @@ STObject::getSortedFields (STObject const& objToSort)
     std::vector<STBase const*> sf;
     sf.reserve (objToSort.getCount ());
 
+    if (objToSort.lazy_)
+        objToSort.materialize ();
+
     // Choose the fields that we need to sort.
     for (detail::STVar const& elem : objToSort.v_)
     {
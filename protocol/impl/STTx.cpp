@@ -33,7 +33,6 @@
 #include <ripple/basics/Log.h>
 #include <ripple/basics/StringUtilities.h>
 #include <ripple/json/to_string.h>
-#include <boost/format.hpp>
 #include <array>
 #include <memory>
 #include <type_traits>
@@ -521,6 +520,81 @@ std::pair<bool, std::string> STTx::checkSign(bool allowMultiSign) const
     return ret;
 }
 
+std::vector<std::pair<bool, std::string>>
+STTx::checkSign(std::vector<STTx const*> const& txs, bool allowMultiSign)
+{
+    std::vector<std::pair<bool, std::string>> ret (
+        txs.size(), {false, "Invalid signature."});
+
+    // Single signatures are collected and checked in one batch.
+    // Reserve up front so the checks can point into these.
+    std::vector<std::size_t> index;
+    std::vector<PublicKey> keys;
+    std::vector<Blob> signatures;
+    std::vector<Blob> data;
+    std::vector<bool> fullyCanonical;
+    index.reserve (txs.size());
+    keys.reserve (txs.size());
+    signatures.reserve (txs.size());
+    data.reserve (txs.size());
+
+    for (std::size_t i = 0; i < txs.size(); ++i)
+    {
+        auto const& tx = *txs[i];
+        try
+        {
+            auto const spk = tx.getFieldVL (sfSigningPubKey);
+            if (allowMultiSign && spk.empty ())
+            {
+                ret[i] = tx.checkMultiSign ();
+                continue;
+            }
+
+            // See checkSingleSign
+            if (tx.isFieldPresent (sfSigners))
+            {
+                ret[i] = {false, "Cannot both single- and multi-sign."};
+                continue;
+            }
+
+            if (! publicKeyType (makeSlice(spk)))
+                continue;
+
+            PublicKey key (makeSlice(spk));
+            auto signature = tx.getFieldVL (sfTxnSignature);
+            auto signingData = getSigningData (tx);
+
+            index.push_back (i);
+            keys.push_back (std::move (key));
+            signatures.push_back (std::move (signature));
+            data.push_back (std::move (signingData));
+            fullyCanonical.push_back (
+                (tx.getFlags() & tfFullyCanonicalSig) != 0);
+        }
+        catch (std::exception const&)
+        {
+            ret[i] = {false, "Internal signature check failure."};
+        }
+    }
+
+    std::vector<SignatureCheck> checks;
+    checks.reserve (index.size());
+    for (std::size_t i = 0; i < index.size(); ++i)
+    {
+        checks.push_back ({&keys[i], makeSlice(data[i]),
+            makeSlice(signatures[i]), fullyCanonical[i]});
+    }
+
+    auto const valid = verifyBatch (checks);
+    for (std::size_t i = 0; i < index.size(); ++i)
+    {
+        if (valid[i])
+            ret[index[i]] = {true, ""};
+    }
+
+    return ret;
+}
+
 Json::Value STTx::getJson (int) const
 {
     Json::Value ret = STObject::getJson (0);
@@ -541,41 +615,6 @@ Json::Value STTx::getJson (int options, bool binary) const
     return getJson(options);
 }
 
-std::string const&
-STTx::getMetaSQLInsertReplaceHeader ()
-{
-    static std::string const sql = "INSERT OR REPLACE INTO Transactions "
-        "(TransID, TransType, FromAcct, FromSeq, LedgerSeq, Status, RawTxn, TxnMeta)"
-        " VALUES ";
-    
-    return sql;
-}
-
-std::string STTx::getMetaSQL (std::uint32_t inLedger,
-                                               std::string const& escapedMetaData) const
-{
-    Serializer s;
-    add (s);
-    return getMetaSQL (s, inLedger, TXN_SQL_VALIDATED, escapedMetaData);
-}
-
-// VFALCO This could be a free function elsewhere
-std::string
-STTx::getMetaSQL (Serializer rawTxn,
-    std::uint32_t inLedger, char status, std::string const& escapedMetaData) const
-{
-    static boost::format bfTrans ("('%s', '%s', '%s', '%d', '%d', '%c', %s, %s)");
-    std::string rTxn = sqlEscape (rawTxn.peekData ());
-
-    auto format = TxFormats::getInstance().findByType (tx_type_);
-    assert (format != nullptr);
-
-    return str (boost::format (bfTrans)
-                % to_string (getTransactionID ()) % format->getName ()
-                % toBase58(getAccountID(sfAccount))
-                % getSequence () % inLedger % status % rTxn % escapedMetaData);
-}
-
 std::pair<bool, std::string> STTx::checkSingleSign () const
 {
     // We don't allow both a non-empty sfSigningPubKey and an sfSigners.
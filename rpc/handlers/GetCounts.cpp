@@ -102,6 +102,12 @@ Json::Value doGetCounts (RPC::Context& context)
     ret[jss::historical_perminute] = static_cast<int>(
         context.app.getInboundLedgers().fetchRate());
     ret[jss::SLE_hit_rate] = context.app.cachedSLEs().rate();
+    ret[jss::SLE_cache_size] = static_cast<Json::UInt>(
+        context.app.cachedSLEs().size());
+    ret[jss::SLE_cache_bytes] = static_cast<Json::UInt>(
+        context.app.cachedSLEs().bytes());
+    ret[jss::SLE_evictions] = static_cast<Json::UInt>(
+        context.app.cachedSLEs().evictions());
     ret[jss::node_hit_rate] = context.app.getNodeStore ().getCacheHitRate ();
     ret[jss::ledger_hit_rate] = context.app.getLedgerMaster ().getCacheHitRate ();
     ret[jss::AL_hit_rate] = context.app.getAcceptedLedgerCache ().getHitRate ();
@@ -109,6 +115,8 @@ Json::Value doGetCounts (RPC::Context& context)
     ret[jss::fullbelow_size] = static_cast<int>(context.app.family().fullbelow().size());
     ret[jss::treenode_cache_size] = context.app.family().treecache().getCacheSize();
     ret[jss::treenode_track_size] = context.app.family().treecache().getTrackSize();
+    ret[jss::serialnode_cache_size] = context.app.family().serialcache().getCacheSize();
+    ret[jss::serialnode_hit_rate] = context.app.family().serialcache().getHitRate();
 
     std::string uptime;
     int s = UptimeTimer::getInstance ().getElapsedSeconds ();
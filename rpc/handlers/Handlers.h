@@ -33,6 +33,7 @@ Json::Value doAccountOffers         (RPC::Context&);
 Json::Value doAccountTx             (RPC::Context&);
 Json::Value doAccountTxSwitch       (RPC::Context&);
 Json::Value doAccountTxOld          (RPC::Context&);
+Json::Value doApplyProfile          (RPC::Context&);
 Json::Value doBookOffers            (RPC::Context&);
 Json::Value doBlackList             (RPC::Context&);
 Json::Value doCanDelete             (RPC::Context&);
@@ -72,6 +73,7 @@ Json::Value doSignFor               (RPC::Context&);
 Json::Value doStop                  (RPC::Context&);
 Json::Value doSubmit                (RPC::Context&);
 Json::Value doSubmitMultiSigned     (RPC::Context&);
+Json::Value doSubmitBatch           (RPC::Context&);
 Json::Value doSubscribe             (RPC::Context&);
 Json::Value doTransactionEntry      (RPC::Context&);
 Json::Value doGetCrossChainTx		(RPC::Context&);
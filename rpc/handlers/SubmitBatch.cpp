@@ -0,0 +1,241 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/main/Application.h>
+#include <ripple/app/misc/HashRouter.h>
+#include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/app/misc/Transaction.h>
+#include <ripple/app/tx/apply.h>
+#include <ripple/core/JobQueue.h>
+#include <ripple/net/RPCErr.h>
+#include <ripple/protocol/ErrorCodes.h>
+#include <ripple/protocol/JsonFields.h>
+#include <ripple/resource/Fees.h>
+#include <ripple/rpc/Context.h>
+
+namespace ripple {
+
+// The most transactions accepted in one request
+static std::size_t const maxBatchSize = 1000;
+
+// The most transactions accepted in one request from a client whose
+// role is charged. Each costs feeMediumBurdenRPC, and the whole batch
+// stays below the balance at which the client is warned.
+static std::size_t const maxLimitedBatchSize = 12;
+
+// Transactions deserialized and verified per unit of work
+static std::size_t const chunkSize = 64;
+
+// {
+//   tx_blobs: [ <blob>, ... ],
+//   fail_hard: <bool>
+// }
+Json::Value doSubmitBatch (RPC::Context& context)
+{
+    if (! context.params.isMember (jss::tx_blobs) ||
+        ! context.params[jss::tx_blobs].isArray ())
+        return RPC::missing_field_error (jss::tx_blobs);
+
+    auto const& blobs = context.params[jss::tx_blobs];
+    if (blobs.size () == 0 || blobs.size () > maxBatchSize)
+        return RPC::invalid_field_error (jss::tx_blobs);
+
+    if (! isUnlimited (context.role) && blobs.size () > maxLimitedBatchSize)
+        return RPC::make_param_error ("Too many transactions in '" +
+            std::string (jss::tx_blobs) + "', at most " +
+            std::to_string (maxLimitedBatchSize) + " are allowed.");
+
+    // Charge what submitting each transaction on its own would
+    Resource::Charge const charge (
+        Resource::feeMediumBurdenRPC.cost () *
+            static_cast<Resource::Charge::value_type> (blobs.size ()),
+        "transaction batch RPC");
+    context.loadType = charge;
+
+    auto const failType = NetworkOPs::doFailHard (
+        context.params.isMember ("fail_hard")
+        && context.params["fail_hard"].asBool ());
+
+    auto& app = context.app;
+    std::size_t const count = blobs.size ();
+
+    Json::Value jvResult;
+    auto& results = jvResult[jss::results] = Json::arrayValue;
+    for (Json::UInt i = 0; i < count; ++i)
+        results.append (Json::objectValue);
+
+    auto const setError = [&results](Json::UInt i,
+        std::string const& error, std::string const& exception)
+    {
+        results[i] = Json::objectValue;
+        results[i][jss::error] = error;
+        results[i][jss::error_exception] = exception;
+    };
+
+    bool const checkSigs = app.checkSigs ();
+
+    // Deserialize and verify in chunks spread over the job queue.
+    // Helper jobs may outlive this handler, so they share this state
+    // rather than referring to the request.
+    struct State
+    {
+        State (Json::Value const& blobs_, Rules const& rules_)
+            : blobs (blobs_)
+            , rules (rules_)
+        {
+        }
+
+        Json::Value const blobs;
+        Rules const rules;
+        std::vector<std::shared_ptr<STTx const>> stxs;
+        std::vector<std::pair<std::string, std::string>> errors;
+    };
+
+    auto state = std::make_shared<State> (blobs,
+        context.ledgerMaster.getCurrentLedger ()->rules ());
+    state->stxs.resize (count);
+    state->errors.resize (count);
+
+    app.getJobQueue ().parallelFor (jtTRANSACTION, "submitBatch",
+        count, chunkSize, 0,
+        [&app, state, checkSigs](std::size_t first, std::size_t last)
+        {
+            auto& s = *state;
+            std::vector<std::shared_ptr<STTx const>> parsed;
+            for (auto i = first; i < last; ++i)
+            {
+                std::pair<Blob, bool> ret (strUnHex (
+                    s.blobs[static_cast<Json::UInt> (i)].asString ()));
+                if (! ret.second || ! ret.first.size ())
+                {
+                    s.errors[i] = {"invalidParams", "invalid tx_blob"};
+                    continue;
+                }
+
+                try
+                {
+                    SerialIter sitTrans (makeSlice (ret.first));
+                    s.stxs[i] = std::make_shared<STTx const> (
+                        std::ref (sitTrans));
+                    parsed.push_back (s.stxs[i]);
+                }
+                catch (std::exception& e)
+                {
+                    s.errors[i] = {"invalidTransaction", e.what ()};
+                }
+            }
+
+            // The results are cached in the HashRouter
+            // for checkValidity below.
+            if (checkSigs)
+            {
+                checkSignatures (app.getHashRouter (), parsed, s.rules);
+            }
+            else
+            {
+                for (auto const& stx : parsed)
+                    forceValidity (app.getHashRouter (),
+                        stx->getTransactionID (), Validity::SigGoodOnly);
+            }
+        });
+
+    auto const& stxs = state->stxs;
+    auto const& rules = state->rules;
+    for (Json::UInt i = 0; i < count; ++i)
+    {
+        if (! state->errors[i].first.empty ())
+            setError (i, state->errors[i].first, state->errors[i].second);
+    }
+
+    // Local checks
+    std::vector<std::shared_ptr<Transaction>> transactions;
+    std::vector<Json::UInt> indexes;
+    transactions.reserve (count);
+    indexes.reserve (count);
+    for (Json::UInt i = 0; i < count; ++i)
+    {
+        if (! stxs[i])
+            continue;
+
+        auto const validity = checkValidity (app.getHashRouter (),
+            *stxs[i], rules, app.config ());
+        if (validity.first != Validity::Valid)
+        {
+            setError (i, "invalidTransaction",
+                "fails local checks: " + validity.second);
+            continue;
+        }
+
+        std::string reason;
+        auto tpTrans = std::make_shared<Transaction> (stxs[i], reason, app);
+        if (tpTrans->getStatus () != NEW)
+        {
+            setError (i, "invalidTransaction",
+                "fails local checks: " + reason);
+            continue;
+        }
+
+        transactions.push_back (std::move (tpTrans));
+        indexes.push_back (i);
+    }
+
+    // Apply
+    if (! transactions.empty ())
+    {
+        try
+        {
+            context.netOps.processTransactionSet (
+                transactions, isUnlimited (context.role), failType);
+        }
+        catch (std::exception& e)
+        {
+            jvResult[jss::error]           = "internalSubmit";
+            jvResult[jss::error_exception] = e.what ();
+
+            return jvResult;
+        }
+    }
+
+    for (std::size_t j = 0; j < transactions.size (); ++j)
+    {
+        auto& result = results[indexes[j]];
+        result[jss::hash] = to_string (transactions[j]->getID ());
+
+        STer const ter = transactions[j]->getResult ();
+        if (temUNCERTAIN != ter.ter)
+        {
+            std::string sToken;
+            std::string sHuman;
+
+            transResultInfo (ter.ter, sToken, sHuman);
+
+            result[jss::engine_result]           = sToken;
+            result[jss::engine_result_code]      = ter.ter;
+            result[jss::engine_result_message]   = sHuman;
+            if (!ter.msg.empty())
+                result[jss::engine_result_message_detail] = ter.msg;
+        }
+    }
+
+    return jvResult;
+}
+
+} // ripple
@@ -107,6 +107,7 @@ Handler handlerArray[] {
     {   "account_objects",      byRef (&doAccountObjects),     Role::USER,  NO_CONDITION  },
     {   "account_offers",       byRef (&doAccountOffers),      Role::USER,  NO_CONDITION  },
     {   "account_tx",           byRef (&doAccountTxSwitch),    Role::USER,  NO_CONDITION  },
+    {   "apply_profile",        byRef (&doApplyProfile),       Role::ADMIN,   NO_CONDITION     },
     {   "blacklist",            byRef (&doBlackList),          Role::ADMIN,   NO_CONDITION     },
     {   "book_offers",          byRef (&doBookOffers),         Role::USER,  NO_CONDITION  },
     {   "can_delete",           byRef (&doCanDelete),          Role::ADMIN,   NO_CONDITION     },
@@ -142,6 +143,7 @@ Handler handlerArray[] {
     {   "sign_for",             byRef (&doSignFor),            Role::USER,  NO_CONDITION     },
     {   "submit",               byRef (&doSubmit),             Role::USER,  NEEDS_CURRENT_LEDGER  },
     {   "submit_multisigned",   byRef (&doSubmitMultiSigned),  Role::USER,  NEEDS_CURRENT_LEDGER  },
+    {   "submit_batch",         byRef (&doSubmitBatch),        Role::USER,  NEEDS_CURRENT_LEDGER  },
     {   "server_info",          byRef (&doServerInfo),         Role::USER,  NO_CONDITION     },
     {   "server_state",         byRef (&doServerState),        Role::USER,  NO_CONDITION     },
     {   "stop",                 byRef (&doStop),               Role::ADMIN,   NO_CONDITION     },
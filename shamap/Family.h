@@ -22,6 +22,7 @@
 
 #include <ripple/basics/Log.h>
 #include <ripple/shamap/FullBelowCache.h>
+#include <ripple/shamap/SerializedNodeCache.h>
 #include <ripple/shamap/TreeNodeCache.h>
 #include <ripple/nodestore/Database.h>
 #include <ripple/beast/utility/Journal.h>
@@ -54,6 +55,14 @@ public:
     TreeNodeCache const&
     treecache() const = 0;
 
+    virtual
+    SerializedNodeCache&
+    serialcache() = 0;
+
+    virtual
+    SerializedNodeCache const&
+    serialcache() const = 0;
+
     virtual
     NodeStore::Database&
     db() = 0;
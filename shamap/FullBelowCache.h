@@ -32,6 +32,10 @@ namespace detail {
 
 /** Remembers which tree keys have all descendants resident.
     This optimizes the process of acquiring a complete tree.
+
+    Inner nodes that are in memory carry the same information as a
+    generation stamp (see SHAMapInnerNode::isFullBelow), which is checked
+    first. This cache is the fallback for nodes that have been evicted.
 */
 template <class Key>
 class BasicFullBelowCache
@@ -0,0 +1,173 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_SHAMAP_SERIALIZEDNODECACHE_H_INCLUDED
+#define RIPPLE_SHAMAP_SERIALIZEDNODECACHE_H_INCLUDED
+
+#include <ripple/shamap/SHAMapTreeNode.h>
+#include <ripple/basics/Blob.h>
+#include <ripple/basics/TaggedCache.h>
+#include <ripple/protocol/Serializer.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace ripple {
+
+/** Retains the serialized forms of immutable tree nodes.
+
+    Serving ledger data to peers (getNodeFat, getFetchPack) and writing
+    nodes to the node store each need the bytes of a node. A node whose
+    sequence is zero can no longer change, so its bytes are determined
+    by its hash and may be shared between all of these consumers.
+
+    Only the prefix (node store / fetch pack) and wire (TMLedgerData)
+    formats are retained; nodes still owned by a mutable map are always
+    serialized afresh.
+*/
+class SerializedNodeCache
+{
+private:
+    using CacheType = TaggedCache <uint256, Blob>;
+
+public:
+    using clock_type = CacheType::clock_type;
+
+    SerializedNodeCache (std::string const& name, int size,
+        clock_type::rep expiration_seconds, clock_type& clock,
+            beast::Journal journal)
+        : prefix_ (name + "Prefix", size, expiration_seconds, clock, journal)
+        , wire_ (name + "Wire", size, expiration_seconds, clock, journal)
+    {
+    }
+
+    /** Return the serialized form of a node.
+
+        Immutable nodes are serialized at most once while their bytes
+        remain in the cache.
+
+        Thread safety:
+            Safe to call from any thread.
+    */
+    std::shared_ptr<Blob const>
+    get (SHAMapAbstractNode const& node, SHANodeFormat format)
+    {
+        auto const cache = select (format);
+
+        if (cache == nullptr || node.getSeq () != 0)
+            return serialize (node, format);
+
+        auto const& key = node.getNodeHash ().as_uint256 ();
+        if (auto blob = lookup (*cache, key))
+            return blob;
+
+        auto blob = serialize (node, format);
+        cache->canonicalize (key, blob);
+        return blob;
+    }
+
+    /** Return the cached serialized form of a node, or nullptr.
+
+        Unlike get, a miss does not serialize or cache the node.
+    */
+    std::shared_ptr<Blob const>
+    fetch (SHAMapHash const& hash, SHANodeFormat format)
+    {
+        if (auto const cache = select (format))
+            return lookup (*cache, hash.as_uint256 ());
+        return nullptr;
+    }
+
+    void
+    setTargetSize (int size)
+    {
+        prefix_.setTargetSize (size);
+        wire_.setTargetSize (size);
+    }
+
+    void
+    setTargetAge (clock_type::rep age)
+    {
+        prefix_.setTargetAge (age);
+        wire_.setTargetAge (age);
+    }
+
+    int
+    getCacheSize () const
+    {
+        return prefix_.getCacheSize () + wire_.getCacheSize ();
+    }
+
+    /** Percentage of lookups, in either format, that were hits. */
+    float
+    getHitRate ()
+    {
+        auto const lookups = static_cast<float> (lookups_.load ());
+        return hits_.load () * (100.0f / std::max (1.0f, lookups));
+    }
+
+    void
+    sweep ()
+    {
+        prefix_.sweep ();
+        wire_.sweep ();
+    }
+
+private:
+    std::shared_ptr<Blob>
+    lookup (CacheType& cache, uint256 const& key)
+    {
+        ++lookups_;
+        auto blob = cache.fetch (key);
+        if (blob)
+            ++hits_;
+        return blob;
+    }
+
+    CacheType*
+    select (SHANodeFormat format)
+    {
+        if (format == snfPREFIX)
+            return &prefix_;
+        if (format == snfWIRE)
+            return &wire_;
+        return nullptr;
+    }
+
+    static
+    std::shared_ptr<Blob>
+    serialize (SHAMapAbstractNode const& node, SHANodeFormat format)
+    {
+        Serializer s;
+        node.addRaw (s, format);
+        return std::make_shared<Blob> (std::move (s.modData ()));
+    }
+
+    CacheType prefix_;
+    CacheType wire_;
+
+    std::atomic<std::uint64_t> hits_ {0};
+    std::atomic<std::uint64_t> lookups_ {0};
+};
+
+} // ripple
+
+#endif
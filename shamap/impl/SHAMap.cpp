@@ -1115,10 +1115,19 @@ SHAMap::writeNode (
 
     canonicalize (node->getNodeHash(), node);
 
-    Serializer s;
-    node->addRaw (s, snfPREFIX);
-    f_.db().store (t,
-        std::move (s.modData ()), node->getNodeHash ().as_uint256());
+    // Reuse bytes already serialized for an identical node. Otherwise
+    // serialize now and hand the buffer to the node store.
+    if (auto blob = f_.serialcache().fetch (node->getNodeHash (), snfPREFIX))
+    {
+        f_.db().store (t, Blob (*blob), node->getNodeHash ().as_uint256());
+    }
+    else
+    {
+        Serializer s;
+        node->addRaw (s, snfPREFIX);
+        f_.db().store (t,
+            std::move (s.modData ()), node->getNodeHash ().as_uint256());
+    }
     return node;
 }
 
@@ -124,44 +124,58 @@ void SHAMap::gmn_ProcessNodes (MissingNodes& mn, MissingNodes::StackEntry& se)
         {
             // we already know this child node is missing
             fullBelow = false;
+            continue;
         }
-        else if (! backed_ || ! f_.fullbelow().touch_if_exists (childHash.as_uint256()))
+
+        // A resident child carries its own full below stamp, so the
+        // hashed cache only needs to be consulted for evicted children
+        auto const resident = node->getChildPointer (branch);
+        if (resident != nullptr && (! resident->isInner () ||
+                static_cast<SHAMapInnerNode*>(resident)->isFullBelow (mn.generation_)))
+            continue;
+
+        if (backed_ && f_.fullbelow().touch_if_exists (childHash.as_uint256()))
         {
-            SHAMapNodeID childID = nodeID.getChildNodeID (branch);
-            bool pending = false;
-            auto d = descendAsync (node, branch, mn.filter_, pending);
+            // Stamp the resident node so the next pass skips the lookup
+            if (resident != nullptr)
+                static_cast<SHAMapInnerNode*>(resident)->setFullBelowGen (mn.generation_);
+            continue;
+        }
 
-            if (!d)
-            {
-                fullBelow = false; // for now, not known full below
+        SHAMapNodeID childID = nodeID.getChildNodeID (branch);
+        bool pending = false;
+        auto d = descendAsync (node, branch, mn.filter_, pending);
 
-                if (! pending)
-                { // node is not in the database
-                    mn.missingHashes_.insert (childHash);
-                    mn.missingNodes_.emplace_back (
-                        childID, childHash.as_uint256());
+        if (!d)
+        {
+            fullBelow = false; // for now, not known full below
 
-                    if (--mn.max_ <= 0)
-                        return;
-                }
-                else
-                    mn.deferredReads_.emplace_back (node, nodeID, branch);
-            }
-            else if (d->isInner() &&
-                 ! static_cast<SHAMapInnerNode*>(d)->isFullBelow(mn.generation_))
-            {
-                mn.stack_.push (se);
+            if (! pending)
+            { // node is not in the database
+                mn.missingHashes_.insert (childHash);
+                mn.missingNodes_.emplace_back (
+                    childID, childHash.as_uint256());
 
-                // Switch to processing the child node
-                node = static_cast<SHAMapInnerNode*>(d);
-                if (auto v2Node = dynamic_cast<SHAMapInnerNodeV2*>(node))
-                    nodeID = SHAMapNodeID{v2Node->depth(), v2Node->key()};
-                else
-                    nodeID = childID;
-                firstChild = rand_int(255);
-                currentChild = 0;
-                fullBelow = true;
+                if (--mn.max_ <= 0)
+                    return;
             }
+            else
+                mn.deferredReads_.emplace_back (node, nodeID, branch);
+        }
+        else if (d->isInner() &&
+             ! static_cast<SHAMapInnerNode*>(d)->isFullBelow(mn.generation_))
+        {
+            mn.stack_.push (se);
+
+            // Switch to processing the child node
+            node = static_cast<SHAMapInnerNode*>(d);
+            if (auto v2Node = dynamic_cast<SHAMapInnerNodeV2*>(node))
+                nodeID = SHAMapNodeID{v2Node->depth(), v2Node->key()};
+            else
+                nodeID = childID;
+            firstChild = rand_int(255);
+            currentChild = 0;
+            fullBelow = true;
         }
     }
 
@@ -412,10 +426,8 @@ bool SHAMap::getNodeFat (SHAMapNodeID wanted,
         stack.pop ();
 
         // Add this node to the reply
-        Serializer s;
-        node->addRaw (s, snfWIRE);
         nodeIDs.push_back (nodeID);
-        rawNodes.push_back (std::move (s.peekData()));
+        rawNodes.push_back (*f_.serialcache().get (*node, snfWIRE));
 
         if (node->isInner())
         {
@@ -448,10 +460,9 @@ bool SHAMap::getNodeFat (SHAMapNodeID wanted,
                         else if (childNode->isInner() || fatLeaves)
                         {
                             // Just include this node
-                            Serializer ns;
-                            childNode->addRaw (ns, snfWIRE);
                             nodeIDs.push_back (childID);
-                            rawNodes.push_back (std::move (ns.peekData ()));
+                            rawNodes.push_back (
+                                *f_.serialcache().get (*childNode, snfWIRE));
                         }
                     }
                 }
@@ -537,7 +548,8 @@ SHAMap::addKnownNode (const SHAMapNodeID& node, Slice const& rawNode,
         }
 
         auto childHash = inner->getChildHash (branch);
-        if (f_.fullbelow().touch_if_exists (childHash.as_uint256()))
+        if ((inner->getChildPointer (branch) == nullptr) &&
+                f_.fullbelow().touch_if_exists (childHash.as_uint256()))
             return SHAMapAddNode::duplicate ();
 
         auto prevNode = inner;
@@ -736,14 +748,13 @@ void SHAMap::getFetchPack (SHAMap const* have, bool includeLeaves, int max,
         JLOG(journal_.info()) << "Can not get fetch pack when versions are different.";
         return;
     }
+    auto& cache = f_.serialcache();
     visitDifferences (have,
-        [includeLeaves, &max, &func] (SHAMapAbstractNode& smn) -> bool
+        [includeLeaves, &max, &func, &cache] (SHAMapAbstractNode& smn) -> bool
         {
             if (includeLeaves || smn.isInner ())
             {
-                Serializer s;
-                smn.addRaw (s, snfPREFIX);
-                func (smn.getNodeHash(), s.peekData());
+                func (smn.getNodeHash(), *cache.get (smn, snfPREFIX));
 
                 if (--max <= 0)
                     return false;
@@ -19,8 +19,10 @@
 
 #include <BeastConfig.h>
 
+#include <ripple/app/misc/impl/AccountHistory.cpp>
 #include <ripple/app/misc/impl/AccountTxPaging.cpp>
 #include <ripple/app/misc/impl/AmendmentTable.cpp>
+#include <ripple/app/misc/impl/BatchVerifier.cpp>
 #include <ripple/app/misc/impl/LoadFeeTrack.cpp>
 #include <ripple/app/misc/impl/Manifest.cpp>
 #include <ripple/app/misc/impl/Transaction.cpp>
@@ -21,6 +21,7 @@
 
 #include <ripple/app/tx/impl/apply.cpp>
 #include <ripple/app/tx/impl/applySteps.cpp>
+#include <ripple/app/tx/impl/ApplyProfiler.cpp>
 #include <ripple/app/tx/impl/BookTip.cpp>
 #include <ripple/app/tx/impl/CancelOffer.cpp>
 #include <ripple/app/tx/impl/CancelTicket.cpp>
@@ -30,6 +31,7 @@
 #include <ripple/app/tx/impl/Escrow.cpp>
 #include <ripple/app/tx/impl/InvariantCheck.cpp>
 #include <ripple/app/tx/impl/OfferStream.cpp>
+#include <ripple/app/tx/impl/ParallelApply.cpp>
 #include <ripple/app/tx/impl/Payment.cpp>
 #include <ripple/app/tx/impl/PayChan.cpp>
 #include <ripple/app/tx/impl/SetAccount.cpp>
@@ -19,3 +19,4 @@
 #include <BeastConfig.h>
 
 #include <ripple/consensus/Consensus.cpp>
+#include <ripple/consensus/ConsensusSim.cpp>
@@ -20,6 +20,7 @@
 #include <BeastConfig.h>
 
 #include <ripple/overlay/impl/Cluster.cpp>
+#include <ripple/overlay/impl/ConsensusBatcher.cpp>
 #include <ripple/overlay/impl/ConnectAttempt.cpp>
 #include <ripple/overlay/impl/Message.cpp>
 #include <ripple/overlay/impl/OverlayImpl.cpp>
@@ -35,6 +35,7 @@
 #include <ripple/rpc/handlers/AccountTx.cpp>
 #include <ripple/rpc/handlers/AccountTxOld.cpp>
 #include <ripple/rpc/handlers/AccountTxSwitch.cpp>
+#include <ripple/rpc/handlers/ApplyProfile.cpp>
 #include <ripple/rpc/handlers/BlackList.cpp>
 #include <ripple/rpc/handlers/BookOffers.cpp>
 #include <ripple/rpc/handlers/CanDelete.cpp>